@@ -83,6 +83,7 @@ list(APPEND PUBLIC_HEADERS ${AUTOCONFIG})
 
 
 set (BUILD_DOCS ON CACHE BOOL "Generate doxygen-based documentation")
+set (BUILD_BENCHMARKS OFF CACHE BOOL "Build and register benchmarks (run with ctest -L benchmark)")
 
 if (NOT CMAKE_BUILD_TYPE)
     set(CMAKE_BUILD_TYPE Release)
@@ -16,6 +16,8 @@ DWIDGET_BEGIN_NAMESPACE
 
 class DVariantListModel : public QAbstractListModel
 {
+    Q_OBJECT
+
 public:
     explicit DVariantListModel(QObject *parent = 0);
 
@@ -26,6 +28,11 @@ public:
     bool insertRows(int row, int count, const QModelIndex &parent = QModelIndex()) Q_DECL_OVERRIDE;
     bool removeRows(int row, int count, const QModelIndex &parent = QModelIndex()) Q_DECL_OVERRIDE;
 
+    bool insertItems(int row, const QVariantList &items);
+    bool insertItems(int row, QVariantList &&items);
+    bool replaceItems(int row, const QVariantList &items);
+    bool replaceItems(int row, QVariantList &&items);
+
 private:
     QList<QVariant> dataList;
 };
@@ -66,6 +73,10 @@ public:
     QMargins itemMargins() const;
     QSize itemSize() const;
 
+    bool isPopulating() const;
+    int populationTimeBudget() const;
+    void setPopulationTimeBudget(int msec);
+
     using QListView::contentsSize;
     using QListView::setViewportMargins;
 
@@ -77,6 +88,11 @@ public Q_SLOTS:
     bool removeItem(int index);
     bool removeItems(int index, int count);
 
+    void addItemsIncrementally(const QVariantList &datas);
+    void insertItemsIncrementally(int index, const QVariantList &datas);
+    void fetchMoreIncrementally();
+    void cancelPopulation();
+
     int addHeaderWidget(QWidget *widget);
     void removeHeaderWidget(int index);
     QWidget *takeHeaderWidget(int index);
@@ -98,6 +114,9 @@ Q_SIGNALS:
     void orientationChanged(Qt::Orientation orientation);
     void currentChanged(const QModelIndex &previous);
     void triggerEdit(const QModelIndex &index);
+    void populationProgress(int inserted, int total);
+    void populationFinished();
+    void populationFailed(int row);
 
 protected:
 #if(QT_VERSION < 0x050500)
@@ -31,6 +31,8 @@ public:
 Q_SIGNALS:
     void paintRequested(DPrinter *printer);
     void paintRequested(DPrinter *printer, const QVector<int> &pageRange);
+    void printJobSubmitted(int jobId);
+    void printJobFailed(const QString &error);
 
 private:
     D_DECLARE_PRIVATE(DPrintPreviewDialog)
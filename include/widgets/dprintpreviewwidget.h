@@ -122,6 +122,8 @@ public:
     void setPrintMode(PrintMode pt);
     void setAsynPreview(int totalPage);
     bool isAsynPreview() const;
+    void setThumbnailBarVisible(bool visible);
+    bool isThumbnailBarVisible() const;
     void isPageByPage(int pageCopy,bool isFirst);
     int targetPageCount(int pageCount);
     int originPageCount();
@@ -135,6 +137,7 @@ public Q_SLOTS:
     void turnEnd();
     void setCurrentPage(int page);
     void print(bool isSavedPicture = false);
+    void cancelExport();
     void themeTypeChanged(DGuiApplicationHelper::ColorType themeType);
 
 Q_SIGNALS:
@@ -144,6 +147,9 @@ Q_SIGNALS:
     void currentPageChanged(int page);
     void totalPages(int);
     void pagesCountChanged(int pages);
+    void exportProgress(int current, int total);
+    void printJobSubmitted(int jobId);
+    void printJobFailed(const QString &error);
 
 private:
     void timerEvent(QTimerEvent *event) override;
@@ -53,6 +53,25 @@ public:
      */
 
     virtual void drawForeground(QRect rect, QPainter *painter, int column, int index, bool isSelect, bool isHover)=0;
+
+    /*
+     * The optional identity key of DSimpleListItem.
+     * Items with the same non-zero key are treated as the same item (same as sameAs returns true),
+     * DSimpleListView uses it to restore selection by hash lookup instead of calling sameAs with every selected item.
+     *
+     * \return the identity key, 0 means the item has no key and sameAs is used instead, default is 0
+     */
+
+    virtual quint64 identityKey() const;
+
+    /*
+     * The optional version of the content drawn by DSimpleListItem.
+     * DSimpleListView::refreshItems only repaints visible rows whose identity key or content version changed.
+     *
+     * \return the content version, 0 means unknown and the row is always repainted, default is 0
+     */
+
+    virtual quint64 contentVersion() const;
 };
 
 DWIDGET_END_NAMESPACE
@@ -72,6 +72,23 @@ public:
      */
     void setSearchAlgorithm(SearchAlgorithm algorithm);
 
+    /*
+     * Keep the relative order of items which compare equal.
+     * Items with identity key also keep their order of last refresh when refreshItems.
+     *
+     * \stable use stable sort, default is false
+     */
+    void setStableSort(bool stable);
+
+    /*
+     * Sort large lists in chunks on worker threads.
+     * The sort algorithm is called from several threads at once and must be thread-safe:
+     * it may only read the items it is given and must not touch widgets or other non thread-safe state.
+     *
+     * \parallel enable parallel sort, default is false
+     */
+    void setParallelSort(bool parallel);
+
     /*
      * Set radius to clip listview.
      *
@@ -143,6 +160,30 @@ public:
      * Search
      */
     void search(QString searchContent);
+
+    /*
+     * Narrow search from the previous result when the search content extends the previous one.
+     * The search algorithm must match every prefix of a content that it matches, such as substring matching.
+     *
+     * \incremental enable incremental search, default is false
+     */
+    void setIncrementalSearch(bool incremental);
+
+    /*
+     * Run the search algorithm on worker thread when the list is large.
+     * The search algorithm must be thread-safe: it may only read the item it is given,
+     * must not touch widgets or other non thread-safe state, and items must not be modified while searching.
+     *
+     * \background enable background search, default is false
+     */
+    void setBackgroundSearch(bool background);
+
+    /*
+     * Whether a background search is running.
+     * With background search enabled, searching large lists runs on worker thread,
+     * the result replaces the displayed items at once when finished.
+     */
+    bool isSearching() const;
     
     /*
      * Set single selection.
@@ -154,6 +195,25 @@ public:
      */
     void keepSelectWhenClickBlank(bool keep);
 
+    /*
+     * Batch changes, the view is repainted once when the outermost endUpdate is called.
+     */
+    void beginUpdate();
+    void endUpdate();
+
+    /*
+     * Cache the rendered foreground of each row as pixmap, only works with items provide identityKey and contentVersion.
+     * The cache is invalid when content version, column widths, device pixel ratio, font or palette changed.
+     *
+     * \enable enable row cache, default is false
+     */
+    void setRowCacheEnabled(bool enable);
+
+    /*
+     * Clear all cached row foreground.
+     */
+    void clearRowCache();
+
     // DSimpleListView operations.
     void selectAllItems();
     void selectFirstItem();
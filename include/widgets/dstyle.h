@@ -117,6 +117,8 @@ public:
         CE_TextButton,
         CE_CustomBase = QStyle::CE_CustomBase + 0xf00000
     };
+    Q_ENUM(PrimitiveElement)
+    Q_ENUM(ControlElement)
 
     enum PixelMetric {
         PM_FocusBorderWidth = QStyle::PM_CustomBase + 1,        //控件焦点状态的边框宽度
@@ -235,6 +237,12 @@ public:
     static void setMenuKeyboardSearchDisabled(bool disabled);
     static bool isMenuKeyboardSearchDisabled();
 
+    static void setPaintProfileEnabled(bool enabled);
+    static bool paintProfileEnabled();
+    static QString paintProfileReport();
+    static void dumpPaintProfile();
+    static void resetPaintProfile();
+
     DStyle();
 
     static void drawPrimitive(const QStyle *style, DStyle::PrimitiveElement pe, const QStyleOption *opt, QPainter *p, const QWidget *w = nullptr);
@@ -259,6 +267,7 @@ public:
 
     void drawPrimitive(QStyle::PrimitiveElement pe, const QStyleOption *opt, QPainter *p, const QWidget *w = nullptr) const override;
     void drawControl(QStyle::ControlElement ce, const QStyleOption *opt, QPainter *p, const QWidget *w = nullptr) const override;
+    void drawComplexControl(QStyle::ComplexControl cc, const QStyleOptionComplex *opt, QPainter *p, const QWidget *w = nullptr) const override;
     int pixelMetric(QStyle::PixelMetric m, const QStyleOption *opt = nullptr, const QWidget *widget = nullptr) const override;
     int styleHint(StyleHint sh, const QStyleOption *opt, const QWidget *w, QStyleHintReturn *shret) const override;
     QRect subElementRect(QStyle::SubElement r, const QStyleOption *opt, const QWidget *widget = nullptr) const override;
@@ -37,6 +37,8 @@ public Q_SLOTS:
 protected:
     void paintEvent(QPaintEvent *) Q_DECL_OVERRIDE;
     void changeEvent(QEvent *e) override;
+    void showEvent(QShowEvent *e) override;
+    void hideEvent(QHideEvent *e) override;
 
 private:
     D_DECLARE_PRIVATE(DWaterProgress)
@@ -4,6 +4,7 @@
 
 #include <QDebug>
 #include <QScrollBar>
+#include <QElapsedTimer>
 
 #include "dboxwidget.h"
 #include "dlistview.h"
@@ -15,6 +16,48 @@
 
 DWIDGET_BEGIN_NAMESPACE
 
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+static void assignVariantList(QVariantList &to, int row, const QVariantList &from)
+{
+    for (int i = 0; i < from.count(); ++i)
+        to[row + i] = from.at(i);
+}
+
+static void assignVariantList(QVariantList &to, int row, QVariantList &&from)
+{
+    for (int i = 0; i < from.count(); ++i)
+        to[row + i] = std::move(from[i]);
+}
+#endif
+
+// 一次完成插入：先整体腾出 count 个位置，再把数据放入，已有数据只搬移一遍
+template<typename Items>
+static void insertVariantList(QVariantList &dataList, int row, Items &&items)
+{
+    const int count = items.count();
+
+    if (dataList.isEmpty()) {
+        dataList = std::forward<Items>(items);
+        return;
+    }
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    dataList.insert(row, count, QVariant());
+    assignVariantList(dataList, row, std::forward<Items>(items));
+#else
+    if (row == dataList.count()) {
+        dataList.append(items);
+    } else {
+        // QList 在 Qt5 中没有批量插入的接口，拆开后一次拼接
+        const QVariantList &tail = dataList.mid(row);
+        dataList.erase(dataList.begin() + row, dataList.end());
+        dataList.reserve(dataList.count() + count + tail.count());
+        dataList.append(items);
+        dataList.append(tail);
+    }
+#endif
+}
+
 DVariantListModel::DVariantListModel(QObject *parent) :
     QAbstractListModel(parent)
 {
@@ -53,11 +96,13 @@ bool DVariantListModel::insertRows(int row, int count, const QModelIndex &parent
     if (count < 1 || row < 0 || row > rowCount(parent))
         return false;
 
-    beginInsertRows(QModelIndex(), row, row + count - 1);
-
+    QVariantList items;
+    items.reserve(count);
     for (int r = 0; r < count; ++r)
-        dataList.insert(row, QVariant());
+        items.append(QVariant());
 
+    beginInsertRows(QModelIndex(), row, row + count - 1);
+    insertVariantList(dataList, row, std::move(items));
     endInsertRows();
 
     return true;
@@ -69,11 +114,81 @@ bool DVariantListModel::removeRows(int row, int count, const QModelIndex &parent
         return false;
 
     beginRemoveRows(QModelIndex(), row, row + count - 1);
+    dataList.erase(dataList.begin() + row, dataList.begin() + row + count);
+    endRemoveRows();
 
-    for (int r = 0; r < count; ++r)
-        dataList.removeAt(row);
+    return true;
+}
 
-    endRemoveRows();
+/*!
+  @~english
+  \brief Insert \a items before \a row in a single step
+  \details Unlike insertRows() followed by setData() for each row, the data is stored
+  in one pass and only one rowsInserted signal is emitted for the whole range.
+  \return Whether it is successful
+ */
+bool DVariantListModel::insertItems(int row, const QVariantList &items)
+{
+    if (items.isEmpty() || row < 0 || row > rowCount())
+        return false;
+
+    beginInsertRows(QModelIndex(), row, row + items.count() - 1);
+    insertVariantList(dataList, row, items);
+    endInsertRows();
+
+    return true;
+}
+
+/*!
+  @~english
+  \overload
+  \details The elements of \a items are moved into the model instead of being copied.
+ */
+bool DVariantListModel::insertItems(int row, QVariantList &&items)
+{
+    if (items.isEmpty() || row < 0 || row > rowCount())
+        return false;
+
+    beginInsertRows(QModelIndex(), row, row + items.count() - 1);
+    insertVariantList(dataList, row, std::move(items));
+    endInsertRows();
+
+    return true;
+}
+
+/*!
+  @~english
+  \brief Replace the data starting at \a row with \a items
+  \details Only one dataChanged signal is emitted for the whole range.
+  \return Whether it is successful, the range must lie inside the model
+ */
+bool DVariantListModel::replaceItems(int row, const QVariantList &items)
+{
+    if (items.isEmpty() || row < 0 || row + items.count() > rowCount())
+        return false;
+
+    for (int i = 0; i < items.count(); ++i)
+        dataList[row + i] = items.at(i);
+
+    Q_EMIT dataChanged(index(row), index(row + items.count() - 1));
+
+    return true;
+}
+
+/*!
+  @~english
+  \overload
+  \details The elements of \a items are moved into the model instead of being copied.
+ */
+bool DVariantListModel::replaceItems(int row, QVariantList &&items)
+{
+    if (items.isEmpty() || row < 0 || row + items.count() > rowCount())
+        return false;
+
+    for (int i = 0; i < items.count(); ++i)
+        dataList[row + i] = std::move(items[i]);
+
+    Q_EMIT dataChanged(index(row), index(row + items.count() - 1));
 
     return true;
 }
@@ -145,6 +260,142 @@ void DListViewPrivate::onOrientationChanged()
     }
 }
 
+void DListViewPrivate::enqueuePopulation(PopulationRequest &&request)
+{
+    const bool idle = populationQueue.isEmpty();
+
+    if (request.fetchMore)
+        ++populationPendingFetch;
+    else
+        populationTotal += request.items.count();
+
+    populationQueue.append(std::move(request));
+
+    // 空闲时同步执行第一个时间片，保证首屏数据在当前帧内就能显示出来
+    if (idle)
+        populateSlice();
+}
+
+void DListViewPrivate::populateSlice()
+{
+    D_Q(DListView);
+
+    QAbstractItemModel *model = q->model();
+    const quint32 generation = populationGeneration;
+    bool ok = model != nullptr;
+    int failedRow = -1;
+    QElapsedTimer sliceTimer;
+    sliceTimer.start();
+
+    while (ok && !populationQueue.isEmpty()) {
+        const QModelIndex root = q->rootIndex();
+        const int rowCount = model->rowCount(root);
+        PopulationRequest &request = populationQueue.first();
+
+        if (request.fetchMore) {
+            if (!model->canFetchMore(root)) {
+                --populationPendingFetch;
+                populationQueue.removeFirst();
+                continue;
+            }
+
+            model->fetchMore(root);
+
+            if (generation != populationGeneration)
+                return;
+
+            const int fetched = model->rowCount(root) - rowCount;
+
+            // 数据是异步到达的，后续的拉取交给视图自身的 fetchMore 机制
+            if (fetched <= 0) {
+                --populationPendingFetch;
+                populationQueue.removeFirst();
+                continue;
+            }
+
+            populationInserted += fetched;
+        } else {
+            const int count = qMin(populationBatch, request.items.count() - request.offset);
+            const int row = request.row < 0 ? rowCount : qMin(request.row + request.offset, rowCount);
+            const qint64 start = sliceTimer.nsecsElapsed();
+
+            ok = q->insertItems(row, request.items.mid(request.offset, count));
+
+            // 模型信号中可能取消或重新开始了填充
+            if (generation != populationGeneration)
+                return;
+
+            if (!ok) {
+                failedRow = row;
+                break;
+            }
+
+            populationInserted += count;
+
+            // 模型信号中可能追加了新的请求，需要重新获取队首
+            PopulationRequest &current = populationQueue.first();
+            current.offset += count;
+
+            if (current.offset >= current.items.count())
+                populationQueue.removeFirst();
+
+            // 根据单批耗时调整批大小，减少模型信号的数量，同时不让单批超出时间预算
+            const qint64 cost = sliceTimer.nsecsElapsed() - start;
+            const qint64 budget = qint64(populationBudget) * 1000000;
+
+            if (cost * 4 < budget && count == populationBatch)
+                populationBatch = qMin(populationBatch * 2, 1 << 16);
+            else if (cost > budget)
+                populationBatch = qMax(populationBatch / 2, 16);
+        }
+
+        if (sliceTimer.elapsed() >= populationBudget)
+            break;
+    }
+
+    if (!ok)
+        populationQueue.clear();
+
+    const int inserted = populationInserted;
+    const int total = populationPendingFetch > 0 ? -1 : populationTotal;
+    const bool finished = populationQueue.isEmpty();
+
+    if (finished) {
+        clearPopulation();
+    } else {
+        if (!populationTimer) {
+            populationTimer = new QTimer(q);
+            populationTimer->setSingleShot(true);
+            populationTimer->setInterval(0);
+            QObject::connect(populationTimer, &QTimer::timeout, q, [this] {
+                populateSlice();
+            });
+        }
+
+        populationTimer->start();
+    }
+
+    Q_EMIT q->populationProgress(inserted, total);
+
+    // 插入失败时剩余的数据已被丢弃，不能当作完成
+    if (!ok)
+        Q_EMIT q->populationFailed(failedRow);
+    else if (finished)
+        Q_EMIT q->populationFinished();
+}
+
+void DListViewPrivate::clearPopulation()
+{
+    ++populationGeneration;
+    populationQueue.clear();
+    populationInserted = 0;
+    populationTotal = 0;
+    populationPendingFetch = 0;
+
+    if (populationTimer)
+        populationTimer->stop();
+}
+
 // ====================Signals begin====================
 /*!
   @~english
@@ -169,6 +420,31 @@ void DListViewPrivate::onOrientationChanged()
   
   \sa QModelIndex QAbstractItemView::EditTrigger
  */
+/*!
+  @~english
+  \fn void DListView::populationProgress(int inserted, int total)
+  \brief This signal is emitted after each batch of incremental population
+
+  \param[in] inserted the number of items inserted since the population started
+  \param[in] total the number of items queued, or -1 while fetching from a lazy model
+
+  \sa DListView::addItemsIncrementally DListView::fetchMoreIncrementally
+ */
+
+/*!
+  @~english
+  \fn void DListView::populationFinished()
+  \brief This signal is emitted when all queued items have been inserted
+ */
+
+/*!
+  @~english
+  \fn void DListView::populationFailed(int row)
+  \brief This signal is emitted when the model refuses a batch of incremental population
+
+  \details The remaining queued items are discarded and populationFinished() is not emitted.
+  \param[in] row the row the rejected batch was inserted at, or -1 if the view has no model
+ */
 // ====================Signals end====================
 
 /*!
@@ -379,6 +655,10 @@ void DListView::setModel(QAbstractItemModel *model)
 {
     QAbstractItemModel *old_model = this->model();
 
+    // 未完成的增量填充针对的是旧模型
+    if (old_model != model && isPopulating())
+        cancelPopulation();
+
     if (old_model) {
         disconnect(old_model, &QAbstractItemModel::rowsInserted, this, &DListView::rowCountChanged);
         disconnect(old_model, &QAbstractItemModel::rowsRemoved, this, &DListView::rowCountChanged);
@@ -452,6 +732,11 @@ bool DListView::addItems(const QVariantList &datas)
  */
 bool DListView::insertItem(int index, const QVariant &data)
 {
+    if (DVariantListModel *variantModel = qobject_cast<DVariantListModel *>(model())) {
+        if (!rootIndex().isValid())
+            return variantModel->insertItems(index, QVariantList { data });
+    }
+
     if (!model()->insertRow(index))
         return false;
 
@@ -467,6 +752,12 @@ bool DListView::insertItem(int index, const QVariant &data)
  */
 bool DListView::insertItems(int index, const QVariantList &datas)
 {
+    // DVariantListModel 可以一次性插入数据，避免逐行 setData 发出大量 dataChanged 信号
+    if (DVariantListModel *variantModel = qobject_cast<DVariantListModel *>(model())) {
+        if (!rootIndex().isValid())
+            return variantModel->insertItems(index, datas);
+    }
+
     if (!model()->insertRows(index, datas.count()))
         return false;
 
@@ -499,6 +790,127 @@ bool DListView::removeItems(int index, int count)
     return model()->removeRows(index, count);
 }
 
+/*!
+  @~english
+  \brief Add items at the bottom of the list incrementally
+
+  \details The items are inserted in batches, each event loop iteration spends at most
+  DListView::populationTimeBudget milliseconds on inserting, so the interface stays responsive
+  even for a very large number of items. The first batch is inserted before this function
+  returns, so the first screen of items is visible within the next frame.
+  Progress is reported by DListView::populationProgress, and DListView::populationFinished is
+  emitted once all queued items have been inserted.
+  \param[in] datas List of new data composition
+
+  \sa DListView::insertItemsIncrementally DListView::cancelPopulation
+ */
+void DListView::addItemsIncrementally(const QVariantList &datas)
+{
+    if (datas.isEmpty())
+        return;
+
+    D_D(DListView);
+
+    DListViewPrivate::PopulationRequest request;
+    request.items = datas;
+    d->enqueuePopulation(std::move(request));
+}
+
+/*!
+  @~english
+  \brief Insert items at the designated row incrementally
+
+  \details Same as DListView::addItemsIncrementally, but the items are inserted starting at
+  \a index. If another population is still in progress, the request is queued and \a index
+  is applied when the request starts.
+  \param[in] index The line number of the first item
+  \param[in] datas List of data composition of items data
+
+  \sa DListView::addItemsIncrementally
+ */
+void DListView::insertItemsIncrementally(int index, const QVariantList &datas)
+{
+    if (datas.isEmpty())
+        return;
+
+    D_D(DListView);
+
+    DListViewPrivate::PopulationRequest request;
+    request.row = qMax(0, index);
+    request.items = datas;
+    d->enqueuePopulation(std::move(request));
+}
+
+/*!
+  @~english
+  \brief Fetch all remaining data of a lazy model incrementally
+
+  \details Calls QAbstractItemModel::fetchMore for the root index while
+  QAbstractItemModel::canFetchMore returns true, within the same time budget as
+  DListView::addItemsIncrementally. If the model delivers data asynchronously (fetchMore
+  does not add rows immediately), fetching stops and is left to the view's own on-scroll fetching.
+  While fetching, DListView::populationProgress reports -1 as the total.
+
+  \sa QAbstractItemModel::canFetchMore QAbstractItemModel::fetchMore
+ */
+void DListView::fetchMoreIncrementally()
+{
+    D_D(DListView);
+
+    DListViewPrivate::PopulationRequest request;
+    request.fetchMore = true;
+    d->enqueuePopulation(std::move(request));
+}
+
+/*!
+  @~english
+  \brief Cancel all pending incremental population
+
+  Items already inserted are kept. DListView::populationFinished is not emitted.
+ */
+void DListView::cancelPopulation()
+{
+    D_D(DListView);
+
+    d->clearPopulation();
+}
+
+/*!
+  @~english
+  \brief Whether there is incremental population in progress
+  \return true if items are still waiting to be inserted
+ */
+bool DListView::isPopulating() const
+{
+    D_DC(DListView);
+
+    return !d->populationQueue.isEmpty();
+}
+
+/*!
+  @~english
+  \brief The time spent on incremental population in each event loop iteration
+  \return the time budget in milliseconds, 8 by default
+ */
+int DListView::populationTimeBudget() const
+{
+    D_DC(DListView);
+
+    return d->populationBudget;
+}
+
+/*!
+  @~english
+  \brief Set the time spent on incremental population in each event loop iteration
+  \param[in] msec the time budget in milliseconds, at least 1
+ */
+void DListView::setPopulationTimeBudget(int msec)
+{
+    D_D(DListView);
+
+    d->populationBudget = qMax(1, msec);
+}
+
 /*!
   @~english
   \brief This function is used to add top controls.
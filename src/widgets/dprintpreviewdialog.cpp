@@ -43,7 +43,9 @@
 #include <QRegularExpressionValidator>
 #include <QStandardPaths>
 #include <QTimer>
+#include <QProgressDialog>
 #include <QKeyEvent>
+#include <QtConcurrent>
 #include <private/qprint_p.h>
 #include <private/qcups_p.h>
 #include <private/qprintdevice_p.h>
@@ -134,6 +136,55 @@ static void _d_setSpinboxDefaultValue(QHash<QWidget *, QString> valueCaches, DSp
     }
 }
 
+// 在工作线程中查询打印机列表及其属性，网络打印机较多时可能耗时数秒
+// 这里不使用 QPrinterInfo，而是直接调用主线程中已加载的打印插件：CUPS 插件 (QCupsPrinterSupport) 本身不保存状态，
+// 每个 QPrintDevice 持有独立的 PPD 数据，libcups 的连接等全局数据按线程保存，因此查询可以在工作线程中进行
+static PrinterInfoSnapshot loadPrinterInfo(QPlatformPrinterSupport *ps)
+{
+    PrinterInfoSnapshot info;
+
+    if (ps) {
+        info.printerNames = ps->availablePrintDeviceIds();
+        info.defaultPrinterName = ps->defaultPrintDeviceId();
+
+        for (const QString &name : qAsConst(info.printerNames)) {
+            PrinterCapabilities capabilities;
+            const QPrintDevice device = ps->createPrintDevice(name);
+            const auto &colorModes = device.supportedColorModes();
+            capabilities.pageSizes = device.supportedPageSizes();
+            // QPrint::DuplexMode 与 QPrinter::DuplexMode 的取值一致
+            for (QPrint::DuplexMode mode : device.supportedDuplexModes())
+                capabilities.duplexModes.append(QPrinter::DuplexMode(mode));
+            capabilities.supportsColor = colorModes.contains(QPrint::Color);
+            capabilities.supportsGrayscale = colorModes.contains(QPrint::GrayScale);
+
+            info.capabilities.insert(name, capabilities);
+        }
+    }
+
+    info.loadedTimer.start();
+    return info;
+}
+
+static PrinterInfoSnapshot &cachedPrinterInfo()
+{
+    static PrinterInfoSnapshot info;
+    return info;
+}
+
+// 多个对话框同时打开时共享同一个查询任务
+static QFuture<PrinterInfoSnapshot> requestPrinterInfo()
+{
+    static QFuture<PrinterInfoSnapshot> future;
+    if (!future.isRunning()) {
+        // 打印插件需要在主线程中加载
+        QPlatformPrinterSupport *ps = QPlatformPrinterSupportPlugin::get();
+        future = QtConcurrent::run(QThreadPool::globalInstance(), loadPrinterInfo, ps);
+    }
+
+    return future;
+}
+
 DPrintPreviewDialogPrivate::DPrintPreviewDialogPrivate(DPrintPreviewDialog *qq)
     : DDialogPrivate(qq)
 {
@@ -1011,17 +1062,12 @@ void DPrintPreviewDialogPrivate::marginsLayout(bool adapted)
 void DPrintPreviewDialogPrivate::initdata()
 {
     QStringList itemlist;
-    itemlist << QPrinterInfo::availablePrinterNames()
-             << qApp->translate("DPrintPreviewDialogPrivate", "Print to PDF")
+    itemlist << qApp->translate("DPrintPreviewDialogPrivate", "Print to PDF")
              << qApp->translate("DPrintPreviewDialogPrivate", "Save as Image");
     printDeviceCombo->addItems(itemlist);
-    QString defauledevice = QPrinterInfo::defaultPrinterName();
-    for (int i = 0; i < itemlist.size(); ++i) {
-        if (defauledevice.compare(itemlist.at(i)) == 0) {
-            printDeviceCombo->setCurrentIndex(i);
-            break;
-        }
-    }
+    // 打印机列表在后台加载，加载完成前仅显示PDF和图片输出，有缓存时直接使用缓存
+    if (!cachedPrinterInfo().printerNames.isEmpty())
+        applyPrinterInfo(cachedPrinterInfo(), true);
     _q_pageRangeChanged(0);
     _q_pageMarginChanged(0);
     _q_printerChanged(printDeviceCombo->currentIndex());
@@ -1033,6 +1079,7 @@ void DPrintPreviewDialogPrivate::initdata()
     settingHelper->setSubControlEnabled(DPrintPreviewSettingInterface::SC_NPrint_Numbers, false);
     isInited = true;
     fontSizeMore = true;
+    refreshPrinterInfo();
 }
 
 void DPrintPreviewDialogPrivate::initconnections()
@@ -1041,6 +1088,8 @@ void DPrintPreviewDialogPrivate::initconnections()
 
     QObject::connect(pview, QOverload<DPrinter *>::of(&DPrintPreviewWidget::paintRequested), q, QOverload<DPrinter *>::of(&DPrintPreviewDialog::paintRequested));
     QObject::connect(pview, QOverload<DPrinter *, const QVector<int> &>::of(&DPrintPreviewWidget::paintRequested), q, QOverload<DPrinter *, const QVector<int> &>::of(&DPrintPreviewDialog::paintRequested));
+    QObject::connect(pview, &DPrintPreviewWidget::printJobSubmitted, q, &DPrintPreviewDialog::printJobSubmitted);
+    QObject::connect(pview, &DPrintPreviewWidget::printJobFailed, q, &DPrintPreviewDialog::printJobFailed);
 
     QObject::connect(advanceBtn, &QPushButton::clicked, q, [this] { this->showadvancesetting(); });
     QObject::connect(printDeviceCombo, SIGNAL(currentIndexChanged(int)), q, SLOT(_q_printerChanged(int)));
@@ -1358,13 +1407,13 @@ void DPrintPreviewDialogPrivate::setupPrinter()
 void DPrintPreviewDialogPrivate::judgeSupportedAttributes(const QString &lastPaperSize)
 {
     Q_Q(DPrintPreviewDialog);
-    QPrinterInfo updateinfo(*printer);
+    const PrinterCapabilities &capabilities = printerInfo.capabilities.value(printer->printerName());
 
     QStringList pageSizeList;
     int index = -1;
-    for (int i = 0; i < updateinfo.supportedPageSizes().size(); i++) {
-        pageSizeList.append(updateinfo.supportedPageSizes().at(i).name());
-        if (index == -1 && updateinfo.supportedPageSizes().at(i).id() == QPageSize::PageSizeId::A4) {
+    for (int i = 0; i < capabilities.pageSizes.size(); i++) {
+        pageSizeList.append(capabilities.pageSizes.at(i).name());
+        if (index == -1 && capabilities.pageSizes.at(i).id() == QPageSize::PageSizeId::A4) {
             index = i;
         }
     }
@@ -1381,17 +1430,17 @@ void DPrintPreviewDialogPrivate::judgeSupportedAttributes(const QString &lastPap
     //判断当前打印机是否支持双面打印，不支持禁用双面打印按钮，pdf不做判断
     QString lastDuplexComboText = duplexCombo->currentText();
     duplexCombo->clear();
-    if (updateinfo.supportedDuplexModes().contains(QPrinter::DuplexLongSide) || updateinfo.supportedDuplexModes().contains(QPrinter::DuplexShortSide)) {
+    if (capabilities.duplexModes.contains(QPrinter::DuplexLongSide) || capabilities.duplexModes.contains(QPrinter::DuplexShortSide)) {
         settingHelper->setSubControlEnabled(DPrintPreviewSettingInterface::SC_DuplexWidget, true);
-        if (!updateinfo.supportedDuplexModes().contains(QPrinter::DuplexLongSide)) {
+        if (!capabilities.duplexModes.contains(QPrinter::DuplexLongSide)) {
             duplexCombo->addItem(qApp->translate("DPrintPreviewDialogPrivate", "Flip on short edge"));
             updateSubControlSettings(DPrintPreviewSettingInfo::PS_PrintDuplex);
             supportedDuplexFlag = false;
-        } else if (!updateinfo.supportedDuplexModes().contains(QPrinter::DuplexShortSide)) {
+        } else if (!capabilities.duplexModes.contains(QPrinter::DuplexShortSide)) {
             duplexCombo->addItem(qApp->translate("DPrintPreviewDialogPrivate", "Flip on long edge"));
             updateSubControlSettings(DPrintPreviewSettingInfo::PS_PrintDuplex);
             supportedDuplexFlag = true;
-        } else if (updateinfo.supportedDuplexModes().contains(QPrinter::DuplexLongSide) && updateinfo.supportedDuplexModes().contains(QPrinter::DuplexShortSide)) {
+        } else if (capabilities.duplexModes.contains(QPrinter::DuplexLongSide) && capabilities.duplexModes.contains(QPrinter::DuplexShortSide)) {
             duplexCombo->addItem(qApp->translate("DPrintPreviewDialogPrivate", "Flip on long edge"));
             duplexCombo->addItem(qApp->translate("DPrintPreviewDialogPrivate", "Flip on short edge"));
             updateSubControlSettings(DPrintPreviewSettingInfo::PS_PrintDuplex);
@@ -1683,10 +1732,9 @@ void DPrintPreviewDialogPrivate::_q_printerChanged(int index)
             judgeSupportedAttributes(lastPaperSize);
         }
         //判断当前打印机是否支持彩色打印，不支持彩色打印删除彩色打印选择选项，pdf不做判断
-        QPlatformPrinterSupport *ps = QPlatformPrinterSupportPlugin::get();
-        QPrintDevice currentDevice = ps->createPrintDevice(printDeviceCombo->currentText());
+        const PrinterCapabilities &capabilities = printerInfo.capabilities.value(currentName);
         supportedColorMode = false;
-        if (currentDevice.supportedColorModes().contains(QPrint::Color)) {
+        if (capabilities.supportsColor) {
             if (!isInited) {
                 waterColor = QColor("#6f6f6f");
                 _q_selectColorButton(waterColor);
@@ -1701,7 +1749,7 @@ void DPrintPreviewDialogPrivate::_q_printerChanged(int index)
             updateSubControlSettings(DPrintPreviewSettingInfo::PS_ColorMode);
             supportedColorMode = true;
         }
-        if (currentDevice.supportedColorModes().contains(QPrint::GrayScale)) {
+        if (capabilities.supportsGrayscale) {
             colorModeCombo->blockSignals(true);
             colorModeCombo->addItem(qApp->translate("DPrintPreviewDialogPrivate", "Grayscale"));
             // Ensure that the signal CurrentIndexChanged is triggered afterwards
@@ -1771,8 +1819,10 @@ void DPrintPreviewDialogPrivate::_q_printerChanged(int index)
     if (pview->pageRangeMode() == DPrintPreviewWidget::SelectPage && pageRangeCombo->isEnabled())
         pageRangeCombo->setCurrentIndex(PAGERANGE_ALL);
     paperSizeCombo->blockSignals(false);
-    if (isInited)
+    if (isInited) {
         updateAllControlSettings();
+        refreshPrinterInfo();
+    }
 }
 
 /*!
@@ -2189,9 +2239,8 @@ void DPrintPreviewDialogPrivate::setPageLayoutEnable(const bool &checked)
 
 void DPrintPreviewDialogPrivate::matchFitablePageSize()
 {
-    QPrinterInfo prInfo(*printer);
     if (isActualPrinter(printDeviceCombo->currentText())) {
-        auto const &pageSizes = prInfo.supportedPageSizes();
+        auto const &pageSizes = printerInfo.capabilities.value(printer->printerName()).pageSizes;
         auto it = std::find_if(pageSizes.cbegin(), pageSizes.cend(), [&](const QPageSize &pageSize) {
             return pageSize.name() == paperSizeCombo->currentText();
         });
@@ -2225,8 +2274,71 @@ void DPrintPreviewDialogPrivate::matchFitablePageSize()
 
 bool DPrintPreviewDialogPrivate::isActualPrinter(const QString &name)
 {
-    const QStringList &printerNames = QPrinterInfo::availablePrinterNames();
-    return printerNames.contains(name);
+    return printerInfo.printerNames.contains(name);
+}
+
+void DPrintPreviewDialogPrivate::refreshPrinterInfo()
+{
+    Q_Q(DPrintPreviewDialog);
+
+    if (!cachedPrinterInfo().isExpired() || (printerInfoWatcher && printerInfoWatcher->isRunning()))
+        return;
+
+    if (!printerInfoWatcher) {
+        printerInfoWatcher = new QFutureWatcher<PrinterInfoSnapshot>(q);
+        QObject::connect(printerInfoWatcher, &QFutureWatcherBase::finished, q, [this] {
+            printerInfoLoaded();
+        });
+    }
+
+    printerInfoWatcher->setFuture(requestPrinterInfo());
+}
+
+/*!
+  \brief DPrintPreviewDialogPrivate::applyPrinterInfo 使用查询到的打印机信息更新打印设备列表
+  \a info 打印机信息
+  \a selectDefault 为 true 时选中默认打印机，否则尽量保持当前选中的设备
+ */
+void DPrintPreviewDialogPrivate::applyPrinterInfo(const PrinterInfoSnapshot &info, bool selectDefault)
+{
+    const QString currentName = printDeviceCombo->currentText();
+    printerInfo = info;
+
+    QStringList itemlist;
+    itemlist << info.printerNames
+             << qApp->translate("DPrintPreviewDialogPrivate", "Print to PDF")
+             << qApp->translate("DPrintPreviewDialogPrivate", "Save as Image");
+    const int index = itemlist.indexOf(selectDefault ? info.defaultPrinterName : currentName);
+
+    printDeviceCombo->blockSignals(true);
+    printDeviceCombo->clear();
+    printDeviceCombo->addItems(itemlist);
+    printDeviceCombo->setCurrentIndex(qMax(0, index));
+    printDeviceCombo->blockSignals(false);
+}
+
+void DPrintPreviewDialogPrivate::printerInfoLoaded()
+{
+    if (printerInfoWatcher->isCanceled())
+        return;
+
+    cachedPrinterInfo() = printerInfoWatcher->result();
+    const PrinterInfoSnapshot &info = cachedPrinterInfo();
+    if (info.printerNames == printerInfo.printerNames && info.capabilities == printerInfo.capabilities) {
+        printerInfo = info;
+        return;
+    }
+
+    const QString currentName = printDeviceCombo->currentText();
+    const PrinterCapabilities currentCapabilities = printerInfo.capabilities.value(currentName);
+    // 首次加载到打印机且用户未切换过设备时选中默认打印机，之后的刷新保持用户的选择
+    applyPrinterInfo(info, printerInfo.printerNames.isEmpty() && printDeviceCombo->currentIndex() == 0);
+
+    if (printDeviceCombo->currentText() != currentName || info.capabilities.value(currentName) != currentCapabilities) {
+        _q_printerChanged(printDeviceCombo->currentIndex());
+    } else {
+        updateSubControlSettings(DPrintPreviewSettingInfo::PS_Printer);
+    }
 }
 
 /*!
@@ -2410,8 +2522,30 @@ void DPrintPreviewDialogPrivate::_q_startPrint(bool clicked)
         pview->setPrintMode(DPrintPreviewWidget::PrintToPrinter);
     }
 
+    // 异步预览导出PDF时分批进行，显示进度并允许中途取消
+    bool exportCanceled = false;
+    QScopedPointer<QProgressDialog> progressDialog;
+    if (isSavePdf && pview->isAsynPreview()) {
+        progressDialog.reset(new QProgressDialog(qApp->translate("DPrintPreviewDialogPrivate", "Exporting PDF..."),
+                                                 qApp->translate("DPrintPreviewDialogPrivate", "Cancel"), 0, 0, q));
+        progressDialog->setWindowModality(Qt::WindowModal);
+        QProgressDialog *dialog = progressDialog.data();
+        QObject::connect(pview, &DPrintPreviewWidget::exportProgress, dialog, [dialog](int current, int total) {
+            dialog->setMaximum(total);
+            dialog->setValue(current);
+        });
+        QObject::connect(dialog, &QProgressDialog::canceled, pview, [this, &exportCanceled] {
+            exportCanceled = true;
+            pview->cancelExport();
+        });
+    }
+
     pview->print();
 
+    // 取消导出后保留对话框，用户可以重新导出
+    if (exportCanceled)
+        return;
+
     q->accept();
 }
 
@@ -2642,6 +2776,9 @@ QString DPrintPreviewDialog::docName() const
 
 /*!
   \brief DPrintPreviewDialog::setPrintFromPath 根据路径的文件进行打印.
+
+  点击打印后会先复制该文件再异步提交给cups，文件只需要在对话框关闭之前保持可读。
+  提交的结果通过 printJobSubmitted 或 printJobFailed 信号通知，对话框销毁后不再通知。
   \a path 文件路径
   \return 设置成功返回 true, 否则返回 false.
  */
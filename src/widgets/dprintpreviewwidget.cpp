@@ -7,11 +7,18 @@
 #include <private/qprinter_p.h>
 #include <QPicture>
 #include <QFileInfo>
+#include <QFile>
+#include <QDir>
+#include <QTemporaryFile>
 #include <QtConcurrent>
+#include <QtMath>
 #include <QtAlgorithms>
 #include <QPaintEngine>
 #include <DWidgetUtil>
 #include <DIconTheme>
+#include <DListView>
+#include <QStandardItemModel>
+#include <QScrollBar>
 
 #include <cups/cups.h>
 #include <cups/ppd.h>
@@ -35,14 +42,220 @@ DWIDGET_BEGIN_NAMESPACE
 
 static void saveImageToFile(int index, const QString &outPutFileName, const QString &suffix, bool isJpegImage, const QImage &srcImage)
 {
-    // write image
+    // write image 在页面光栅化的工作线程中直接保存
     QString stres = outPutFileName.right(suffix.length() + 1);
     QString tmpString = outPutFileName.left(outPutFileName.length() - suffix.length() - 1) + QString("(%1)").arg(QString::number(index + 1)) + stres;
 
-    // 多线程保存文件修复大文件卡顿问题
-    QtConcurrent::run(QThreadPool::globalInstance(), [srcImage, tmpString, isJpegImage] {
-        srcImage.save(tmpString, isJpegImage ? "JPEG" : "PNG");
-    });
+    srcImage.save(tmpString, isJpegImage ? "JPEG" : "PNG");
+}
+
+static void drawSinglePageContent(QPainter *painter, const QSize &contentSize, qreal scale, qreal waterRotation, const QSize &translateSize, const QPointF &leftTop, const QImage &waterImage, const QPicture &picture)
+{
+    // 绘制原始数据
+    painter->save();
+    if (scale > 1) {
+        // Bug-61709: Qt原因右下页边距在缩放大于100后出现失效问题，这里先用一个临时的解决办法处理
+        QImage tmpImage(contentSize * scale, QImage::Format_ARGB32);
+        tmpImage.fill(Qt::white);
+        QPainter tmpPainter(&tmpImage);
+        tmpPainter.scale(scale, scale);
+        tmpPainter.drawPicture(0, 0, picture);
+
+        painter->setRenderHint(QPainter::SmoothPixmapTransform);
+        // 将缩放系数设置为1
+        painter->resetTransform();
+        // 由小到大缩放的时候  图片数据容易失真  这里直接将原始数据绘制到放大后的图片中 然后再进行绘图 数据失真程度较低
+        painter->drawImage(leftTop, tmpImage);
+    } else {
+        painter->drawPicture(leftTop, picture);
+    }
+    // 绘制水印
+    if (!waterImage.isNull()) {
+        painter->resetTransform();
+        painter->translate(translateSize.width() / 2, translateSize.height() / 2);
+        painter->rotate(waterRotation);
+
+        painter->drawImage(-waterImage.width() / 2, -waterImage.height() / 2, waterImage);
+    }
+
+    painter->restore();
+}
+
+static void drawMultiPageContent(QPainter *painter, const QSize &contentSize, qreal scale, qreal scaleRatio, const QVector<QPointF> &paintPoints, const QList<QPicture> &pictures, const QPointF &leftTop, const QImage &waterImage)
+{
+    painter->setRenderHint(QPainter::SmoothPixmapTransform);
+
+    painter->save();
+    painter->scale(scaleRatio, scaleRatio);
+    if (scale > 1) {
+        // Bug-61709: Qt原因右下页边距在缩放大于100后出现失效问题，这里先用一个临时的解决办法处理
+        QImage tmpImage(contentSize / scaleRatio, QImage::Format_ARGB32);
+        tmpImage.fill(Qt::white);
+        QPainter tmpPainter(&tmpImage);
+
+        // 为了保证并打缩放的清晰度 防止先缩放小再缩放大导致图像不清晰的问题 这里直接将并打内容放大 然后在统一缩小到并打大小
+        for (int c = 0; c < pictures.count(); ++c) {
+            QPointF paintPoint = paintPoints.at(c) / scaleRatio;
+            tmpPainter.drawPicture(paintPoint, pictures.at(c));
+        }
+
+        painter->drawImage(leftTop / scaleRatio, tmpImage);
+    } else {
+        for (int c = 0; c < pictures.count(); ++c) {
+            QPointF paintPoint = paintPoints.at(c) / scaleRatio;
+            painter->drawPicture(leftTop / scaleRatio + paintPoint, pictures.at(c));
+        }
+    }
+    painter->restore();
+
+    // 绘制并打水印 此时不能再设置缩放比
+    if (!waterImage.isNull())
+        painter->drawImage(leftTop, waterImage);
+}
+
+// 进程内只加载一次 cups 库，并解析所有需要用到的函数
+struct CupsFunctions
+{
+    CupsFunctions()
+        : library("cups", "2")
+    {
+        //  libcups2-dev libcups2
+        if (!library.load()) {
+            qWarning() << "Cups not found";
+            return;
+        }
+
+        isLoaded = true;
+        cupsPrintFile = reinterpret_cast<decltype(cupsPrintFile)>(library.resolve("cupsPrintFile"));
+        cupsLastErrorString = reinterpret_cast<decltype(cupsLastErrorString)>(library.resolve("cupsLastErrorString"));
+        cupsGetNamedDest = reinterpret_cast<decltype(cupsGetNamedDest)>(library.resolve("cupsGetNamedDest"));
+        cupsFreeDests = reinterpret_cast<decltype(cupsFreeDests)>(library.resolve("cupsFreeDests"));
+        cupsGetPPD = reinterpret_cast<decltype(cupsGetPPD)>(library.resolve("cupsGetPPD"));
+        ppdOpenFile = reinterpret_cast<decltype(ppdOpenFile)>(library.resolve("ppdOpenFile"));
+        ppdMarkDefaults = reinterpret_cast<decltype(ppdMarkDefaults)>(library.resolve("ppdMarkDefaults"));
+        cupsMarkOptions = reinterpret_cast<decltype(cupsMarkOptions)>(library.resolve("cupsMarkOptions"));
+        ppdLocalize = reinterpret_cast<decltype(ppdLocalize)>(library.resolve("ppdLocalize"));
+        ppdFindOption = reinterpret_cast<decltype(ppdFindOption)>(library.resolve("ppdFindOption"));
+    }
+
+    QLibrary library;
+    bool isLoaded = false;
+    int (*cupsPrintFile)(const char *name, const char *filename, const char *title, int num_options, cups_option_t *options) = nullptr;
+    const char *(*cupsLastErrorString)() = nullptr;
+    cups_dest_t *(*cupsGetNamedDest)(http_t *http, const char *name, const char *instance) = nullptr;
+    void (*cupsFreeDests)(int num_dests, cups_dest_t *dests) = nullptr;
+    const char *(*cupsGetPPD)(const char *name) = nullptr;
+    ppd_file_t *(*ppdOpenFile)(const char *filename) = nullptr;
+    void (*ppdMarkDefaults)(ppd_file_t *ppd) = nullptr;
+    int (*cupsMarkOptions)(ppd_file_t *ppd, int num_options, cups_option_t *options) = nullptr;
+    int (*ppdLocalize)(ppd_file_t *ppd) = nullptr;
+    ppd_option_t *(*ppdFindOption)(ppd_file_t *ppd, const char *keyword) = nullptr;
+};
+
+static const CupsFunctions &cupsFunctions()
+{
+    static const CupsFunctions functions;
+    return functions;
+}
+
+static QByteArray colorModelByCups(const QString &printerName)
+{
+    const auto parts = printerName.split(QLatin1Char('/'));
+    const auto printerOriginalName = parts.at(0);
+
+    QByteArray m_cupsInstance;
+    if (parts.size() > 1)
+        m_cupsInstance = parts.at(1).toUtf8();
+
+    const CupsFunctions &cups = cupsFunctions();
+    if (!cups.isLoaded)
+        return {};
+
+    auto cupsGetNamedDest = cups.cupsGetNamedDest;
+
+    if (!cupsGetNamedDest) {
+        qWarning() << "cupsGetNamedDest Function load failed.";
+        return {};
+    }
+
+    auto cupsFreeDests = cups.cupsFreeDests;
+
+    if (!cupsFreeDests) {
+        qWarning() << "cupsFreeDests Function load failed.";
+        return {};
+    }
+
+    // 根据打印机名称获取cup实例 用于读取ppd文件
+    cups_dest_t *m_cupsDest = cupsGetNamedDest(CUPS_HTTP_DEFAULT, printerOriginalName.toLocal8Bit(), m_cupsInstance.isNull() ? nullptr : m_cupsInstance.constData());
+
+    if (m_cupsDest) {
+        ppd_file_t *m_ppd = nullptr;
+        auto cupsGetPPD = cups.cupsGetPPD;
+
+        if (!cupsGetPPD) {
+            qWarning() << "cupsGetPPD Function load failed.";
+            cupsFreeDests(1, m_cupsDest);
+            return {};
+        }
+
+        // 获取对应打印机的ppd文件指针
+        const char *ppdFile = cupsGetPPD(printerOriginalName.toLocal8Bit());
+
+        if (ppdFile) {
+            auto ppdOpenFile = cups.ppdOpenFile;
+
+            if (!ppdOpenFile) {
+                qWarning() << "ppdOpenFile Function load failed.";
+                cupsFreeDests(1, m_cupsDest);
+                return {};
+            }
+
+            // 打开ppd文件
+            m_ppd = ppdOpenFile(ppdFile);
+            unlink(ppdFile);
+        }
+
+        if (m_ppd) {
+            auto ppdMarkDefaults = cups.ppdMarkDefaults;
+            auto cupsMarkOptions = cups.cupsMarkOptions;
+            auto ppdLocalize = cups.ppdLocalize;
+            auto ppdFindOption = cups.ppdFindOption;
+
+            if (!ppdMarkDefaults || !cupsMarkOptions || !ppdLocalize || !ppdFindOption) {
+                qWarning() << "ppdMarkDefaults, cupsMarkOptions, ppdLocalize, ppdFindOption function load failed.";
+                cupsFreeDests(1, m_cupsDest);
+                return {};
+            }
+
+            ppdMarkDefaults(m_ppd);
+            cupsMarkOptions(m_ppd, m_cupsDest->num_options, m_cupsDest->options);
+            ppdLocalize(m_ppd);
+
+            // 从ppd文件中找到对应属性
+            ppd_option_t *colorModel = ppdFindOption(m_ppd, "ColorModel");
+
+            if (colorModel) {
+                for (int i = 0; i < colorModel->num_choices; ++i) {
+                    ppd_choice_t *choice = colorModel->choices + i;
+
+                    if (QString(choice->choice).startsWith("gray", Qt::CaseInsensitive)) {
+                        continue;
+                    } else {
+                        // 寻找ColorModel属性 获取到时返回支持的颜色
+                        QByteArray colorModel(choice->choice);
+                        cupsFreeDests(1, m_cupsDest);
+                        return colorModel;
+                    }
+                }
+            }
+        } else {
+            cupsFreeDests(1, m_cupsDest);
+            m_cupsDest = nullptr;
+            m_ppd = nullptr;
+        }
+    }
+
+    return {};
 }
 
 DPrintPreviewWidgetPrivate::DPrintPreviewWidgetPrivate(DPrintPreviewWidget *qq)
@@ -54,6 +267,10 @@ DPrintPreviewWidgetPrivate::DPrintPreviewWidgetPrivate(DPrintPreviewWidget *qq)
     , isAsynPreview(false)
     , asynPreviewNeedUpdate(false)
     , numberUpPrintData(nullptr)
+    , pageCache(PREVIEW_PAGE_CACHE_LIMIT)
+    , grayscaleCache(PREVIEW_GRAYSCALE_CACHE_LIMIT)
+    , numberUpSheetCache(PREVIEW_NUMBERUP_SHEET_CACHE_LIMIT)
+    , waterMarkImageCache(PREVIEW_WATERMARK_CACHE_LIMIT)
 {
 }
 
@@ -82,7 +299,8 @@ void DPrintPreviewWidgetPrivate::init()
     scene->addItem(waterMark);
     waterMark->setZValue(1);
 
-    QVBoxLayout *layout = new QVBoxLayout(q);
+    // 左侧的缩略图列表在启用时才会创建并插入
+    QHBoxLayout *layout = new QHBoxLayout(q);
     layout->setContentsMargins(10, 10, 10, 10);
     layout->addWidget(graphicsView);
 
@@ -141,7 +359,14 @@ void DPrintPreviewWidgetPrivate::updatePreview()
 void DPrintPreviewWidgetPrivate::generatePreview()
 {
     int totalPages = 0;
+    // 页面内容重新生成，灰度缓存、并打页面缓存及缩略图失效
+    grayscaleCache.clear();
+    numberUpSheetCache.clear();
+    ++previewGeneration;
     if (isAsynPreview) {
+        // 重新生成预览时页面内容可能已经改变（纸张、方向等），缓存的页面全部失效
+        prefetchTimer.stop();
+        pageCache.clear();
         if (currentPageNumber == 0) {
             pageRange.clear();
             for (int i = 1; i <= asynPreviewTotalPage; i++) {
@@ -238,6 +463,98 @@ void DPrintPreviewWidgetPrivate::asynPrint(const QPointF &leftTop, const QRect &
     }
 }
 
+void DPrintPreviewWidgetPrivate::streamPrint(const QPointF &leftTop, const QRect &pageRect, const QVector<int> &pageVector, const QVector<int> &printPages)
+{
+    Q_Q(DPrintPreviewWidget);
+
+    // previewPrinter 在导出期间一直处于绘制状态，页面数据通过设置相同的临时打印机请求
+    DPrinter requestPrinter;
+    requestPrinter.setResolution(previewPrinter->resolution());
+    requestPrinter.setPageLayout(previewPrinter->pageLayout());
+    requestPrinter.setFullPage(previewPrinter->fullPage());
+    requestPrinter.setColorMode(previewPrinter->colorMode());
+    requestPrinter.setDocName(previewPrinter->docName());
+
+    const bool isNumberUp = imposition != DPrintPreviewWidget::One;
+    const int sheetPageCount = isNumberUp ? numberUpPrintData->rowCount * numberUpPrintData->columnCount : 1;
+    const int sheetCount = isNumberUp ? q->targetPageCount(pageVector.size()) : printPages.size();
+    const int sheetsPerChunk = qMax(1, PREVIEW_EXPORT_CHUNK_PAGES / sheetPageCount);
+
+    // 与 asynPrint 中 pictures 的索引方式保持一致
+    auto sheetPages = [&](int sheet) -> QVector<int> {
+        if (!isNumberUp)
+            return {printPages.at(sheet)};
+        if (order == DPrintPreviewWidget::Copy)
+            return QVector<int>(sheetPageCount, printPages.at(sheet));
+        return printPages.mid(sheet * sheetPageCount, sheetPageCount);
+    };
+
+    exportCanceled = false;
+    exporting = true;
+
+    QPainter painter(previewPrinter);
+    painter.setClipRect(0, 0, pageRect.width(), pageRect.height());
+    painter.scale(scale, scale);
+
+    QImage waterMarkImage = isNumberUp ? QImage() : generateWaterMarkImage();
+    for (int sheet = 0; sheet < sheetCount && !exportCanceled;) {
+        // 每次只请求若干张纸的页面数据，绘制完成后即释放
+        const int chunkEnd = qMin(sheetCount, sheet + sheetsPerChunk);
+        QVector<QVector<int>> chunkSheets;
+        QVector<int> chunkPages;
+        for (int i = sheet; i < chunkEnd; ++i) {
+            chunkSheets.append(sheetPages(i));
+            chunkPages += chunkSheets.last();
+        }
+
+        const QList<QPicture> &chunkPictures = fetchPreviewPages(chunkPages, &requestPrinter);
+        if (chunkPictures.count() != chunkPages.count()) {
+            qWarning() << "Export pdf failed, requested" << chunkPages.count() << "pages but got" << chunkPictures.count();
+            break;
+        }
+
+        int offset = 0;
+        for (int i = sheet; i < chunkEnd; ++i) {
+            if (0 != i)
+                previewPrinter->newPage();
+
+            const QVector<int> &pages = chunkSheets.at(i - sheet);
+            if (isNumberUp) {
+                numberUpPrintData->previewPictures.clear();
+                for (int c = 0; c < pages.count(); ++c)
+                    numberUpPrintData->previewPictures.append(qMakePair(pages.at(c), &chunkPictures.at(offset + c)));
+
+                // 并打时 水印需要在第一次或者当前页数与总页面数量不一致时重新生成
+                if ((0 == i) || (numberUpPrintData->previewPictures.count() != numberUpPrintData->paintPoints.count()))
+                    waterMarkImage = generateWaterMarkImage();
+
+                printMultiPageDrawUtil(&painter, leftTop, waterMarkImage);
+            } else {
+                printSinglePageDrawUtil(&painter, pageRect.size(), leftTop, waterMarkImage, &chunkPictures.at(offset));
+            }
+
+            offset += pages.count();
+        }
+
+        sheet = chunkEnd;
+        Q_EMIT q->exportProgress(sheet, sheetCount);
+
+        // 每一批之间处理事件，使界面可以刷新进度并响应取消操作
+        if (sheet < sheetCount && !exportCanceled)
+            QCoreApplication::processEvents();
+    }
+
+    painter.end();
+    exporting = false;
+
+    // 恢复当前预览页面的并打数据，导出时使用的页面数据已经释放
+    if (isNumberUp)
+        calculateCurrentNumberPage();
+
+    if (exportCanceled)
+        QFile::remove(previewPrinter->outputFileName());
+}
+
 void DPrintPreviewWidgetPrivate::syncPrint(const QPointF &leftTop, const QRect &pageRect, const QVector<int> &pageVector)
 {
     QPainter painter(previewPrinter);
@@ -280,18 +597,12 @@ void DPrintPreviewWidgetPrivate::syncPrint(const QPointF &leftTop, const QRect &
 void DPrintPreviewWidgetPrivate::printAsImage(const QSize &paperSize, QVector<int> &pageVector)
 {
     QMargins pageMargins = previewPrinter->pageLayout().marginsPixels(previewPrinter->resolution());
-    QImage savedImages(paperSize, QImage::Format_ARGB32);
+    const QRect paintRect = previewPrinter->pageLayout().paintRectPixels(previewPrinter->resolution());
     QString outPutFileName = previewPrinter->outputFileName();
     QString suffix = QFileInfo(outPutFileName).suffix();
     bool isJpegImage = !suffix.compare(QLatin1String("jpeg"), Qt::CaseInsensitive);
     QImage waterMarkImage = (imposition == DPrintPreviewWidget::One) ? generateWaterMarkImage() : QImage();
 
-    savedImages.fill(Qt::white);
-
-    QPainter painter(&savedImages);
-    painter.setClipRect(previewPrinter->pageLayout().paintRectPixels(previewPrinter->resolution()));
-    painter.scale(scale, scale);
-
     QPointF leftTopPoint;
     if (scale >= 1.0) {
         leftTopPoint = QPointF(pageMargins.left() / scale, pageMargins.top() / scale);
@@ -302,6 +613,65 @@ void DPrintPreviewWidgetPrivate::printAsImage(const QSize &paperSize, QVector<in
     // 水印需要调整的位置大小  跟随页面内容位置变化
     QSize translateSize = paperSize + QSize(pageMargins.left() - pageMargins.right(), pageMargins.top() - pageMargins.bottom());
 
+    // 页面在线程池中并行光栅化并保存，绘制参数需要在主线程中提前获取
+    const bool isNumberUp = imposition != DPrintPreviewWidget::One;
+    const qreal pageScale = scale;
+    const qreal waterRotation = waterMark->rotation();
+    const qreal scaleRatio = isNumberUp ? numberUpPrintData->scaleRatio : 1.0;
+    const QVector<QPointF> paintPoints = isNumberUp ? numberUpPrintData->paintPoints : QVector<QPointF>();
+
+    // 按内存预算限制同时处理的页面，每页占用纸张大小的 ARGB32 图像（放大时还有一张同样大小的临时图像）
+    // 和页面数据的深拷贝，文件仍按页码顺序命名
+    const int maxPendingPages = qMax(1, QThreadPool::globalInstance()->maxThreadCount());
+    const qint64 memoryLimit = qint64(PREVIEW_IMAGE_PRINT_MEMORY_LIMIT) * 1024;
+    const qint64 imageBytes = qint64(paperSize.width()) * paperSize.height() * 4 * (pageScale > 1 ? 2 : 1);
+    qint64 pendingBytes = 0;
+    QList<QPair<QFuture<void>, qint64>> pendingPages;
+    auto rasterizePage = [&](int index, const QList<const QPicture *> &sheetPictures, const QImage &waterImage) {
+        qint64 pageBytes = imageBytes;
+        for (const QPicture *picture : sheetPictures)
+            pageBytes += picture->size();
+
+        // 单页超出预算时退化为逐页处理
+        while (!pendingPages.isEmpty() && (pendingBytes + pageBytes > memoryLimit || pendingPages.count() >= maxPendingPages)) {
+            auto page = pendingPages.takeFirst();
+            page.first.waitForFinished();
+            pendingBytes -= page.second;
+        }
+
+        // QPicture 回放时会修改共享数据，每个线程需要使用独立的深拷贝
+        QList<QPicture> pagePictures;
+        for (const QPicture *picture : sheetPictures) {
+            QPicture copy(*picture);
+            copy.detach();
+            pagePictures.append(copy);
+        }
+
+        pendingBytes += pageBytes;
+        pendingPages.append(qMakePair(QtConcurrent::run(QThreadPool::globalInstance(), [=] {
+            QImage savedImage(paperSize, QImage::Format_ARGB32);
+            savedImage.fill(Qt::white);
+
+            QPainter painter(&savedImage);
+            painter.setClipRect(paintRect);
+            painter.scale(pageScale, pageScale);
+            if (isNumberUp) {
+                drawMultiPageContent(&painter, paintRect.size(), pageScale, scaleRatio, paintPoints, pagePictures, leftTopPoint, waterImage);
+            } else {
+                drawSinglePageContent(&painter, paintRect.size(), pageScale, waterRotation, translateSize, leftTopPoint, waterImage, pagePictures.first());
+            }
+            painter.end();
+
+            saveImageToFile(index, outPutFileName, suffix, isJpegImage, savedImage);
+        }), pageBytes));
+    };
+    auto numberUpSheetPictures = [this] {
+        QList<const QPicture *> sheetPictures;
+        for (const auto &picPair : qAsConst(numberUpPrintData->previewPictures))
+            sheetPictures.append(picPair.second);
+        return sheetPictures;
+    };
+
     if (isAsynPreview) {
         // 异步先获取需要打印的数据
         if (pageRangeMode == DPrintPreviewWidget::CurrentPage) {
@@ -315,11 +685,8 @@ void DPrintPreviewWidgetPrivate::printAsImage(const QSize &paperSize, QVector<in
         if (imposition == DPrintPreviewWidget::One) {
             // 异步+非并打
             // 异步模式下pictures可以直接按顺序拿取
-            for (int i = 0; i < pageVector.size(); ++i) {
-                printSinglePageDrawUtil(&painter, translateSize, leftTopPoint, waterMarkImage, pictures.at(i));
-                saveImageToFile(i, outPutFileName, suffix, isJpegImage, savedImages);
-                savedImages.fill(Qt::white);
-            }
+            for (int i = 0; i < pageVector.size(); ++i)
+                rasterizePage(i, {pictures.at(i)}, waterMarkImage);
         } else {
             // 异步+并打
             int curPageCount = numberUpPrintData->rowCount * numberUpPrintData->columnCount;
@@ -341,9 +708,7 @@ void DPrintPreviewWidgetPrivate::printAsImage(const QSize &paperSize, QVector<in
                 if ((0 == i) || (numberUpPrintData->previewPictures.count() != numberUpPrintData->paintPoints.count()))
                     waterMarkImage = generateWaterMarkImage();
 
-                printMultiPageDrawUtil(&painter, leftTopPoint, waterMarkImage);
-                saveImageToFile(i, outPutFileName, suffix, isJpegImage, savedImages);
-                savedImages.fill(Qt::white);
+                rasterizePage(i, numberUpSheetPictures(), waterMarkImage);
             }
         }
     } else {
@@ -352,11 +717,8 @@ void DPrintPreviewWidgetPrivate::printAsImage(const QSize &paperSize, QVector<in
             updatePageByPagePrintVector(pageVector, pictures);
             // 同步+非并打
             // 同步模式下需要按照位置拿取
-            for (int i = 0; i < pageVector.size(); ++i) {
-                printSinglePageDrawUtil(&painter, translateSize, leftTopPoint, waterMarkImage, pictures[pageVector.at(i) - 1]);
-                saveImageToFile(i, outPutFileName, suffix, isJpegImage, savedImages);
-                savedImages.fill(Qt::white);
-            }
+            for (int i = 0; i < pageVector.size(); ++i)
+                rasterizePage(i, {pictures[pageVector.at(i) - 1]}, waterMarkImage);
         } else {
             // 同步+并打
             for (int i = 0; i < q_func()->targetPageCount(pageVector.size()); ++i) {
@@ -373,78 +735,30 @@ void DPrintPreviewWidgetPrivate::printAsImage(const QSize &paperSize, QVector<in
                 if ((0 == i) || (numberUpPrintData->previewPictures.count() != numberUpPrintData->paintPoints.count()))
                     waterMarkImage = generateWaterMarkImage();
 
-                printMultiPageDrawUtil(&painter, leftTopPoint, waterMarkImage);
-                saveImageToFile(i, outPutFileName, suffix, isJpegImage, savedImages);
-                savedImages.fill(Qt::white);
+                rasterizePage(i, numberUpSheetPictures(), waterMarkImage);
             }
         }
     }
+
+    // 等待剩余页面光栅化完成，pictures中的数据在此之前必须保持有效
+    for (auto &page : pendingPages)
+        page.first.waitForFinished();
 }
 
 void DPrintPreviewWidgetPrivate::printSinglePageDrawUtil(QPainter *painter, const QSize &translateSize, const QPointF &leftTop, const QImage &waterImage, const QPicture *picture)
 {
-    // 绘制原始数据
-    painter->save();
-    if (scale > 1) {
-        // Bug-61709: Qt原因右下页边距在缩放大于100后出现失效问题，这里先用一个临时的解决办法处理
-        QImage tmpImage(previewPrinter->pageLayout().paintRectPixels(previewPrinter->resolution()).size() * scale, QImage::Format_ARGB32);
-        tmpImage.fill(Qt::white);
-        QPainter tmpPainter(&tmpImage);
-        tmpPainter.scale(scale, scale);
-        tmpPainter.drawPicture(0, 0, *picture);
-
-        painter->setRenderHint(QPainter::SmoothPixmapTransform);
-        // 将缩放系数设置为1
-        painter->resetTransform();
-        // 由小到大缩放的时候  图片数据容易失真  这里直接将原始数据绘制到放大后的图片中 然后再进行绘图 数据失真程度较低
-        painter->drawImage(leftTop, tmpImage);
-    } else {
-        painter->drawPicture(leftTop, *picture);
-    }
-    // 绘制水印
-    if (!waterImage.isNull()) {
-        painter->resetTransform();
-        painter->translate(translateSize.width() / 2, translateSize.height() / 2);
-        painter->rotate(waterMark->rotation());
-
-        painter->drawImage(-waterImage.width() / 2, -waterImage.height() / 2, waterImage);
-    }
-
-    painter->restore();
+    const QSize &contentSize = previewPrinter->pageLayout().paintRectPixels(previewPrinter->resolution()).size();
+    drawSinglePageContent(painter, contentSize, scale, waterMark->rotation(), translateSize, leftTop, waterImage, *picture);
 }
 
 void DPrintPreviewWidgetPrivate::printMultiPageDrawUtil(QPainter *painter, const QPointF &leftTop, const QImage &waterImage)
 {
-    painter->setRenderHint(QPainter::SmoothPixmapTransform);
+    QList<QPicture> sheetPictures;
+    for (const auto &picPair : qAsConst(numberUpPrintData->previewPictures))
+        sheetPictures.append(*picPair.second);
 
-    painter->save();
-    painter->scale(numberUpPrintData->scaleRatio, numberUpPrintData->scaleRatio);
-    if (scale > 1) {
-        // Bug-61709: Qt原因右下页边距在缩放大于100后出现失效问题，这里先用一个临时的解决办法处理
-        QImage tmpImage(previewPrinter->pageLayout().paintRectPixels(previewPrinter->resolution()).size() / numberUpPrintData->scaleRatio, QImage::Format_ARGB32);
-        tmpImage.fill(Qt::white);
-        QPainter tmpPainter(&tmpImage);
-
-        // 为了保证并打缩放的清晰度 防止先缩放小再缩放大导致图像不清晰的问题 这里直接将并打内容放大 然后在统一缩小到并打大小
-        for (int c = 0; c < numberUpPrintData->previewPictures.count(); ++c) {
-            QPointF paintPoint = numberUpPrintData->paintPoints.at(c) / numberUpPrintData->scaleRatio;
-            const QPicture *pic = numberUpPrintData->previewPictures.at(c).second;
-            tmpPainter.drawPicture(paintPoint, *pic);
-        }
-
-        painter->drawImage(leftTop / numberUpPrintData->scaleRatio, tmpImage);
-    } else {
-        for (int c = 0; c < numberUpPrintData->previewPictures.count(); ++c) {
-            QPointF paintPoint = numberUpPrintData->paintPoints.at(c) / numberUpPrintData->scaleRatio;
-            const QPicture *pic = numberUpPrintData->previewPictures.at(c).second;
-            painter->drawPicture(leftTop / numberUpPrintData->scaleRatio + paintPoint, *pic);
-        }
-    }
-    painter->restore();
-
-    // 绘制并打水印 此时不能再设置缩放比
-    if (!waterImage.isNull())
-        painter->drawImage(leftTop, waterImage);
+    const QSize &contentSize = previewPrinter->pageLayout().paintRectPixels(previewPrinter->resolution()).size();
+    drawMultiPageContent(painter, contentSize, scale, numberUpPrintData->scaleRatio, numberUpPrintData->paintPoints, sheetPictures, leftTop, waterImage);
 }
 
 void DPrintPreviewWidgetPrivate::print(bool printAsPicture)
@@ -468,7 +782,23 @@ void DPrintPreviewWidgetPrivate::print(bool printAsPicture)
             leftTopPoint = {pageRect.width() * (1.0 - scale) / (2.0 * scale), pageRect.height() * (1.0 - scale) / (2.0 * scale)};
         }
 
-        if (isAsynPreview) {
+        if (isAsynPreview && printMode == DPrintPreviewWidget::PrintToPdf) {
+            // 异步导出PDF时分批请求页面数据，不再一次性持有整个文档
+            QVector<int> printPages = (pageRangeMode == DPrintPreviewWidget::CurrentPage) ? requestPages(pageVector.first()) : pageVector;
+            // 与 updatePageByPagePrintVector 中对 pictures 的处理保持一致
+            if (pageCopyCount > 1) {
+                QVector<int> copyPages;
+                for (int page : qAsConst(printPages))
+                    copyPages += QVector<int>(pageCopyCount, page);
+                printPages = copyPages;
+            }
+            if (pageCopyCount != 0 && !isFirstPage)
+                std::reverse(printPages.begin(), printPages.end());
+
+            QList<const QPicture *> unusedPictures;
+            updatePageByPagePrintVector(pageVector, unusedPictures);
+            streamPrint(leftTopPoint, pageRect, pageVector, printPages);
+        } else if (isAsynPreview) {
             // 异步先获取需要打印的数据
             if (pageRangeMode == DPrintPreviewWidget::CurrentPage) {
                 previewPages = requestPages(pageVector.first());
@@ -660,6 +990,11 @@ int DPrintPreviewWidgetPrivate::impositionPages(DPrintPreviewWidget::Imposition
 
 QImage DPrintPreviewWidgetPrivate::generateWaterMarkImage() const
 {
+    // 水印参数未发生变化时直接复用已生成的图像，各个打印流程及每一页共享同一份水印
+    const QString &key = waterMarkImageKey();
+    if (QImage *image = waterMarkImageCache.object(key))
+        return *image;
+
     auto drawSingleWaterMarkImage = [ = ]() -> QImage {
         QRectF itemMaxRect = waterMark->itemMaxPolygon().boundingRect();
         QImage originImage(itemMaxRect.size().toSize(), QImage::Format_ARGB32);
@@ -689,9 +1024,7 @@ QImage DPrintPreviewWidgetPrivate::generateWaterMarkImage() const
     };
 
     QImage waterMarkImage = drawSingleWaterMarkImage();
-    if (imposition == DPrintPreviewWidget::One) {
-        return waterMarkImage;
-    } else {
+    if (imposition != DPrintPreviewWidget::One) {
         const QRectF &pageRect = previewPrinter->pageLayout().paintRectPixels(previewPrinter->resolution());
         qreal rotation = numberUpPrintData->waterList.isEmpty() ? 0 : numberUpPrintData->waterList.first()->rotation();
 
@@ -719,11 +1052,49 @@ QImage DPrintPreviewWidgetPrivate::generateWaterMarkImage() const
             tp.drawImage(paintPoint, singleWaterImage);
         }
         tp.end();
-        return totalWaterImage;
+        waterMarkImage = totalWaterImage;
     }
+
+    // 以 KB 为单位计算缓存开销
+    const int cost = qMax<qint64>(1, static_cast<qint64>(waterMarkImage.width()) * waterMarkImage.height() * waterMarkImage.depth() / 8 / 1024);
+    waterMarkImageCache.insert(key, new QImage(waterMarkImage), cost);
+
+    return waterMarkImage;
+}
+
+QString DPrintPreviewWidgetPrivate::waterMarkImageKey() const
+{
+    const bool isNumberUp = imposition != DPrintPreviewWidget::One && numberUpPrintData;
+    const WaterMark *wm = waterMark;
+    if (isNumberUp && !numberUpPrintData->waterList.isEmpty())
+        wm = numberUpPrintData->waterList.first();
+
+    const QRect &pageRect = previewPrinter->pageLayout().paintRectPixels(previewPrinter->resolution());
+    QStringList keys;
+    keys << QString::number(wm->type) << QString::number(wm->layout) << wm->text << wm->font.toString()
+         << QString::number(wm->color.rgba()) << QString::number(wm->rotation()) << QString::number(wm->opacity())
+         << QString::number(wm->mScaleFactor) << QString::number(wm->sourceImage.cacheKey())
+         << QString::number(wm->graySourceImage.cacheKey()) << QString::number(previewPrinter->colorMode())
+         << q_func()->property("_d_print_waterMarkRowSpacing").toString()
+         << q_func()->property("_d_print_waterMarkColumnSpacing").toString()
+         << QString::number(previewPrinter->resolution())
+         << QString::number(pageRect.width()) << QString::number(pageRect.height())
+         << QString::number(imposition);
+
+    if (isNumberUp) {
+        // 并打水印按照当前页面中小页面的数量和位置拼接
+        keys << QString::number(order) << QString::number(numberUpPrintData->scaleRatio)
+             << QString::number(numberUpPrintData->previewPictures.count());
+        for (const QPointF &point : qAsConst(numberUpPrintData->paintPoints))
+            keys << QString::number(point.x()) + QLatin1Char(',') + QString::number(point.y());
+    } else {
+        keys << QString::number(wm->numberUpScale);
+    }
+
+    return keys.join(QLatin1Char('|'));
 }
 
-PrintOptions DPrintPreviewWidgetPrivate::printerOptions()
+PrintOptions DPrintPreviewWidgetPrivate::printerOptions(bool resolveColorModel)
 {
     PrintOptions options;
 
@@ -768,7 +1139,7 @@ PrintOptions DPrintPreviewWidgetPrivate::printerOptions()
 
     if (previewPrinter->colorMode() == QPrinter::GrayScale) {
         options.append(QPair<QByteArray, QByteArray>(QStringLiteral("ColorModel").toLocal8Bit(), QStringLiteral("Gray").toLocal8Bit()));
-    } else {
+    } else if (resolveColorModel) {
         Q_Q(DPrintPreviewWidget);
         QByteArray colorModel = q->printerColorModel();
         options.append(QPair<QByteArray, QByteArray>(QStringLiteral("ColorModel").toLocal8Bit(), colorModel.isEmpty() ? QByteArrayLiteral("RGB") : colorModel));
@@ -777,58 +1148,191 @@ PrintOptions DPrintPreviewWidgetPrivate::printerOptions()
     return options;
 }
 
+// 复制待打印的文件，返回副本路径，复制失败时返回空字符串
+static QString copyPrintFile(const QString &path)
+{
+    QFile source(path);
+    if (!source.open(QIODevice::ReadOnly))
+        return QString();
+
+    QTemporaryFile copy(QDir::tempPath() + QStringLiteral("/dtk-print-XXXXXX.") + QFileInfo(path).suffix());
+    if (!copy.open())
+        return QString();
+
+    while (!source.atEnd()) {
+        const QByteArray data = source.read(1024 * 1024);
+        if (data.isEmpty() || copy.write(data) != data.size())
+            return QString();
+    }
+
+    if (!copy.flush())
+        return QString();
+
+    // 副本由提交任务的工作线程在cups读取后删除
+    copy.setAutoRemove(false);
+    return copy.fileName();
+}
+
 void DPrintPreviewWidgetPrivate::printByCups()
 {
-    //  libcups2-dev libcups2
-    QLibrary cupsLibrary("cups", "2");
-    if (!cupsLibrary.isLoaded()) {
-        if (!cupsLibrary.load()) {
-            qWarning() << "Cups not found";
-            return;
+    Q_Q(DPrintPreviewWidget);
+
+    // 查询打印机颜色模式和提交任务都需要与cups服务通信，统一放到工作线程中执行，避免阻塞界面
+    const bool resolveColorModel = previewPrinter->colorMode() != QPrinter::GrayScale;
+    const PrintOptions options = printerOptions(false);
+    const QString printerName = previewPrinter->printerName();
+    const QString docName = previewPrinter->docName();
+
+    // 任务在print返回后才提交，调用方此时可能已经删除或覆盖了源文件，因此提交前先复制一份
+    const QString filePath = copyPrintFile(printFromPath);
+    if (filePath.isEmpty()) {
+        const QString error = QStringLiteral("Failed to read %1").arg(printFromPath);
+        qWarning() << "Failed to submit print job:" << error;
+        QMetaObject::invokeMethod(q, [q, error] {
+            Q_EMIT q->printJobFailed(error);
+        }, Qt::QueuedConnection);
+        return;
+    }
+
+    // 每个打印任务使用独立的watcher，连续提交时不会丢失任务结果
+    auto watcher = new QFutureWatcher<QPair<int, QString>>(q);
+    QObject::connect(watcher, &QFutureWatcherBase::finished, q, [watcher, q] {
+        const QPair<int, QString> result = watcher->result();
+        watcher->deleteLater();
+
+        if (result.first > 0) {
+            Q_EMIT q->printJobSubmitted(result.first);
+        } else {
+            qWarning() << "Failed to submit print job:" << result.second;
+            Q_EMIT q->printJobFailed(result.second);
         }
+    });
+
+    auto submit = [=]() -> QPair<int, QString> {
+        const CupsFunctions &cups = cupsFunctions();
+        if (!cups.isLoaded)
+            return qMakePair(0, QStringLiteral("Cups not found"));
+
+        if (!cups.cupsPrintFile)
+            return qMakePair(0, QStringLiteral("cupsPrintFile function load failed"));
+
+        PrintOptions jobOptions = options;
+        if (resolveColorModel) {
+            const QByteArray colorModel = colorModelByCups(printerName);
+            jobOptions.append(QPair<QByteArray, QByteArray>(QByteArrayLiteral("ColorModel"), colorModel.isEmpty() ? QByteArrayLiteral("RGB") : colorModel));
+        }
+
+        const int numOptions = jobOptions.size();
+        QVector<cups_option_t> cupsOptStruct;
+        cupsOptStruct.reserve(numOptions);
+
+        for (int c = 0; c < numOptions; ++c) {
+            cups_option_t opt;
+            opt.name = jobOptions[c].first.data();
+            opt.value = jobOptions[c].second.data();
+            cupsOptStruct.append(opt);
+        }
+
+        cups_option_t *optPtr = cupsOptStruct.size() ? &cupsOptStruct.first() : nullptr;
+        const int jobId = cups.cupsPrintFile(printerName.toLocal8Bit().constData(), filePath.toLocal8Bit().constData(),
+                                             docName.toLocal8Bit().constData(), numOptions, optPtr);
+        if (jobId > 0)
+            return qMakePair(jobId, QString());
+
+        // cupsLastErrorString 为线程局部数据，需要在提交任务的线程中读取
+        const char *error = cups.cupsLastErrorString ? cups.cupsLastErrorString() : nullptr;
+        return qMakePair(0, error ? QString::fromUtf8(error) : QStringLiteral("cupsPrintFile failed"));
+    };
+
+    // cupsPrintFile 返回前已将文件内容发送给cups服务，任务本身不依赖预览控件，控件销毁后副本同样会被删除
+    watcher->setFuture(QtConcurrent::run(QThreadPool::globalInstance(), [submit, filePath]() -> QPair<int, QString> {
+        const QPair<int, QString> result = submit();
+        QFile::remove(filePath);
+        return result;
+    }));
+}
+
+void DPrintPreviewWidgetPrivate::generatePreviewPicture()
+{
+    Q_Q(DPrintPreviewWidget);
+
+    if (isAsynPreview) {
+        // 异步模式下只渲染需要的页面，pictures指向targetPictures中的数据，避免被缓存淘汰后失效
+        targetPictures = fetchPreviewPages(previewPages);
+        pictures.clear();
+        for (const QPicture &picture : qAsConst(targetPictures))
+            pictures.append(&picture);
+
+        return;
     }
 
-    int (*cupsPrintFile)(const char *name, const char *filename,
-                         const char *title, int num_options,
-                         cups_option_t *options) = nullptr;
-    cupsPrintFile = reinterpret_cast<decltype(cupsPrintFile)>(cupsLibrary.resolve("cupsPrintFile"));
-    if (!cupsPrintFile) {
-        qWarning() << "cupsPrintFile function load failed";
-        return;
-    }
+    previewPrinter->setPreviewMode(true);
+    Q_EMIT q->paintRequested(previewPrinter);
+    previewPrinter->setPreviewMode(false);
+    pictures = previewPrinter->getPrinterPages();
+}
+
+QList<QPicture> DPrintPreviewWidgetPrivate::fetchPreviewPages(const QVector<int> &pageVector, DPrinter *printer)
+{
+    Q_Q(DPrintPreviewWidget);
+
+    if (!printer)
+        printer = previewPrinter;
+
+    // 先拷贝缓存中已存在的页面，防止后续插入新页面时被淘汰
+    QHash<int, QPicture> fetched;
+    QVector<int> missingPages;
+    for (int page : pageVector) {
+        if (fetched.contains(page) || missingPages.contains(page))
+            continue;
 
-    PrintOptions options = printerOptions();
-    const int numOptions = options.size();
+        if (QPicture *picture = pageCache.object(page)) {
+            fetched.insert(page, *picture);
+        } else {
+            missingPages.append(page);
+        }
+    }
 
-    QVector<cups_option_t> cupsOptStruct;
-    cupsOptStruct.reserve(numOptions);
+    if (!missingPages.isEmpty()) {
+        printer->setPreviewMode(true);
+        Q_EMIT q->paintRequested(printer, missingPages);
+        printer->setPreviewMode(false);
 
-    for (int c = 0; c < numOptions; ++c) {
-        cups_option_t opt;
-        opt.name = options[c].first.data();
-        opt.value = options[c].second.data();
-        cupsOptStruct.append(opt);
+        // 打印机中的页面数据在下一次绘制时会被释放，这里拷贝一份（QPicture为隐式共享）放入缓存
+        const QList<const QPicture *> &printerPages = printer->getPrinterPages();
+        for (int i = 0; i < missingPages.count() && i < printerPages.count(); ++i) {
+            const QPicture &picture = *printerPages.at(i);
+            fetched.insert(missingPages.at(i), picture);
+            pageCache.insert(missingPages.at(i), new QPicture(picture), qMax(1, int(picture.size() / 1024)));
+        }
     }
 
-    QString printerName = previewPrinter->printerName();
-    cups_option_t *optPtr = cupsOptStruct.size() ? &cupsOptStruct.first() : nullptr;
+    QList<QPicture> result;
+    for (int page : pageVector) {
+        auto it = fetched.constFind(page);
+        if (it != fetched.constEnd())
+            result.append(it.value());
+    }
 
-    cupsPrintFile(printerName.toLocal8Bit().constData(), printFromPath.toLocal8Bit().constData(),
-                  previewPrinter->docName().toLocal8Bit().constData(), numOptions, optPtr);
+    return result;
 }
 
-void DPrintPreviewWidgetPrivate::generatePreviewPicture()
+void DPrintPreviewWidgetPrivate::prefetchNeighbourPages()
 {
-    Q_Q(DPrintPreviewWidget);
+    if (!isAsynPreview)
+        return;
 
-    previewPrinter->setPreviewMode(true);
-    if (isAsynPreview) {
-        Q_EMIT q->paintRequested(previewPrinter, previewPages);
-    } else {
-        Q_EMIT q->paintRequested(previewPrinter);
+    QVector<int> neighbourPages;
+    const int pageCount = pagesCount();
+    for (int page : {currentPageNumber + 1, currentPageNumber - 1}) {
+        if (page < FIRST_PAGE || page > pageCount)
+            continue;
+
+        neighbourPages += requestPages(page);
     }
-    previewPrinter->setPreviewMode(false);
-    pictures = previewPrinter->getPrinterPages();
+
+    if (!neighbourPages.isEmpty())
+        fetchPreviewPages(neighbourPages);
 }
 
 void DPrintPreviewWidgetPrivate::calculateNumberPageScale()
@@ -946,114 +1450,7 @@ void DPrintPreviewWidgetPrivate::calculateCurrentNumberPage()
 
 QByteArray DPrintPreviewWidgetPrivate::foundColorModelByCups() const
 {
-    const auto parts = previewPrinter->printerName().split(QLatin1Char('/'));
-    const auto printerOriginalName = parts.at(0);
-
-    QByteArray m_cupsInstance;
-    if (parts.size() > 1)
-        m_cupsInstance = parts.at(1).toUtf8();
-
-    QLibrary cupsLibrary("cups", "2");
-    if (!cupsLibrary.isLoaded()) {
-        if (!cupsLibrary.load()) {
-            qWarning() << "Cups not found";
-            return {};
-        }
-    }
-
-    cups_dest_t *(*cupsGetNamedDest)(http_t * http, const char *name, const char *instance) = nullptr;
-    cupsGetNamedDest = reinterpret_cast<decltype(cupsGetNamedDest)>(cupsLibrary.resolve("cupsGetNamedDest"));
-
-    if (!cupsGetNamedDest) {
-        qWarning() << "cupsGetNamedDest Function load failed.";
-        return {};
-    }
-
-    void (*cupsFreeDests)(int num_dests, cups_dest_t *dests) = nullptr;
-    cupsFreeDests = reinterpret_cast<decltype(cupsFreeDests)>(cupsLibrary.resolve("cupsFreeDests"));
-
-    if (!cupsFreeDests) {
-        qWarning() << "cupsFreeDests Function load failed.";
-        return {};
-    }
-
-    // 根据打印机名称获取cup实例 用于读取ppd文件
-    cups_dest_t *m_cupsDest = cupsGetNamedDest(CUPS_HTTP_DEFAULT, printerOriginalName.toLocal8Bit(), m_cupsInstance.isNull() ? nullptr : m_cupsInstance.constData());
-
-    if (m_cupsDest) {
-        ppd_file_t *m_ppd = nullptr;
-        const char *(*cupsGetPPD)(const char *name) = nullptr;
-        cupsGetPPD = reinterpret_cast<decltype(cupsGetPPD)>(cupsLibrary.resolve("cupsGetPPD"));
-
-        if (!cupsGetPPD) {
-            qWarning() << "cupsGetPPD Function load failed.";
-            cupsFreeDests(1, m_cupsDest);
-            return {};
-        }
-
-        // 获取对应打印机的ppd文件指针
-        const char *ppdFile = cupsGetPPD(printerOriginalName.toLocal8Bit());
-
-        if (ppdFile) {
-            ppd_file_t *(*ppdOpenFile)(const char *filename) = nullptr;
-            ppdOpenFile = reinterpret_cast<decltype(ppdOpenFile)>(cupsLibrary.resolve("ppdOpenFile"));
-
-            if (!ppdOpenFile) {
-                qWarning() << "ppdOpenFile Function load failed.";
-                cupsFreeDests(1, m_cupsDest);
-                return {};
-            }
-
-            // 打开ppd文件
-            m_ppd = ppdOpenFile(ppdFile);
-            unlink(ppdFile);
-        }
-
-        if (m_ppd) {
-            void (*ppdMarkDefaults)(ppd_file_t * ppd) = nullptr;
-            int (*cupsMarkOptions)(ppd_file_t * ppd, int num_options, cups_option_t *options) = nullptr;
-            int (*ppdLocalize)(ppd_file_t * ppd) = nullptr;
-            ppd_option_t *(*ppdFindOption)(ppd_file_t * ppd, const char *keyword) = nullptr;
-            ppdMarkDefaults = reinterpret_cast<decltype(ppdMarkDefaults)>(cupsLibrary.resolve("ppdMarkDefaults"));
-            cupsMarkOptions = reinterpret_cast<decltype(cupsMarkOptions)>(cupsLibrary.resolve("cupsMarkOptions"));
-            ppdLocalize = reinterpret_cast<decltype(ppdLocalize)>(cupsLibrary.resolve("ppdLocalize"));
-            ppdFindOption = reinterpret_cast<decltype(ppdFindOption)>(cupsLibrary.resolve("ppdFindOption"));
-
-            if (!ppdMarkDefaults || !cupsMarkOptions || !ppdLocalize || !ppdFindOption) {
-                qWarning() << "ppdMarkDefaults, cupsMarkOptions, ppdLocalize, ppdFindOption function load failed.";
-                cupsFreeDests(1, m_cupsDest);
-                return {};
-            }
-
-            ppdMarkDefaults(m_ppd);
-            cupsMarkOptions(m_ppd, m_cupsDest->num_options, m_cupsDest->options);
-            ppdLocalize(m_ppd);
-
-            // 从ppd文件中找到对应属性
-            ppd_option_t *colorModel = ppdFindOption(m_ppd, "ColorModel");
-
-            if (colorModel) {
-                for (int i = 0; i < colorModel->num_choices; ++i) {
-                    ppd_choice_t *choice = colorModel->choices + i;
-
-                    if (QString(choice->choice).startsWith("gray", Qt::CaseInsensitive)) {
-                        continue;
-                    } else {
-                        // 寻找ColorModel属性 获取到时返回支持的颜色
-                        QByteArray colorModel(choice->choice);
-                        cupsFreeDests(1, m_cupsDest);
-                        return colorModel;
-                    }
-                }
-            }
-        } else {
-            cupsFreeDests(1, m_cupsDest);
-            m_cupsDest = nullptr;
-            m_ppd = nullptr;
-        }
-    }
-
-    return {};
+    return colorModelByCups(previewPrinter->printerName());
 }
 
 void DPrintPreviewWidgetPrivate::displayWaterMarkItem()
@@ -1164,6 +1561,258 @@ void DPrintPreviewWidgetPrivate::releaseImpositionData()
     numberUpPrintData = nullptr;
 }
 
+QString DPrintPreviewWidgetPrivate::grayscaleCacheKey()
+{
+    QStringList pageList;
+    if (imposition == DPrintPreviewWidget::One || !numberUpPrintData) {
+        pageList.append(QString::number(index2page(currentPageNumber - 1)));
+    } else {
+        for (const auto &picPair : qAsConst(numberUpPrintData->previewPictures))
+            pageList.append(QString::number(picPair.first));
+    }
+
+    const QSize pageSize = previewPrinter->pageLayout().paintRectPixels(previewPrinter->resolution()).size();
+    return QStringLiteral("%1:%2x%3:%4:%5:%6")
+            .arg(previewPrinter->resolution())
+            .arg(pageSize.width())
+            .arg(pageSize.height())
+            .arg(imposition)
+            .arg(order)
+            .arg(pageList.join(QLatin1Char(',')));
+}
+
+QString DPrintPreviewWidgetPrivate::numberUpSheetKey(qreal deviceScale)
+{
+    QStringList pageList;
+    for (const auto &picPair : qAsConst(numberUpPrintData->previewPictures))
+        pageList.append(QString::number(picPair.first));
+
+    // 水印、颜色模式等设置不影响小页面的拼接，不作为键值
+    const QSize pageSize = previewPrinter->pageLayout().paintRectPixels(previewPrinter->resolution()).size();
+    return QStringLiteral("%1:%2:%3:%4:%5:%6x%7:%8")
+            .arg(currentPageNumber)
+            .arg(imposition)
+            .arg(order)
+            .arg(numberUpPrintData->scaleRatio)
+            .arg(deviceScale)
+            .arg(pageSize.width())
+            .arg(pageSize.height())
+            .arg(pageList.join(QLatin1Char(',')));
+}
+
+QVector<int> DPrintPreviewWidgetPrivate::sheetSourcePages(int sheet)
+{
+    QVector<int> sourcePages;
+    if (imposition == DPrintPreviewWidget::One) {
+        int page = index2page(sheet - 1);
+        if (page != -1)
+            sourcePages.append(page);
+        return sourcePages;
+    }
+
+    int count = impositionPages(imposition);
+    if (order == DPrintPreviewWidget::Copy) {
+        int page = index2page(sheet - 1);
+        if (page != -1)
+            sourcePages = QVector<int>(count, page);
+        return sourcePages;
+    }
+
+    for (int c = 0; c < count; ++c) {
+        int page = index2page((sheet - 1) * count + c);
+        if (page == -1)
+            break;
+
+        sourcePages.append(page);
+    }
+
+    return sourcePages;
+}
+
+void DPrintPreviewWidgetPrivate::initThumbnailBar()
+{
+    Q_Q(DPrintPreviewWidget);
+
+    thumbnailModel = new QStandardItemModel(q);
+    thumbnailView = new DListView(q);
+    thumbnailView->setModel(thumbnailModel);
+    thumbnailView->setViewMode(QListView::IconMode);
+    thumbnailView->setFlow(QListView::TopToBottom);
+    thumbnailView->setWrapping(false);
+    thumbnailView->setMovement(QListView::Static);
+    thumbnailView->setUniformItemSizes(true);
+    thumbnailView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    thumbnailView->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    thumbnailView->setIconSize(QSize(PREVIEW_THUMBNAIL_WIDTH, PREVIEW_THUMBNAIL_WIDTH));
+    thumbnailView->setFixedWidth(PREVIEW_THUMBNAIL_WIDTH * 3 / 2);
+
+    thumbnailWatcher = new QFutureWatcher<QImage>(q);
+
+    if (QBoxLayout *layout = qobject_cast<QBoxLayout *>(q->layout()))
+        layout->insertWidget(0, thumbnailView);
+
+    QObject::connect(thumbnailView, &QAbstractItemView::clicked, q, [q](const QModelIndex &index) {
+        q->setCurrentPage(index.row() + 1);
+    });
+    // 滚动后优先生成新出现在可见范围内的缩略图
+    QObject::connect(thumbnailView->verticalScrollBar(), &QScrollBar::valueChanged, q, [this, q] {
+        thumbnailTimer.start(0, q);
+    });
+    QObject::connect(q, &DPrintPreviewWidget::currentPageChanged, q, [this] {
+        resetThumbnails();
+    });
+    QObject::connect(q, &DPrintPreviewWidget::totalPages, q, [this] {
+        resetThumbnails();
+    });
+    QObject::connect(q, &DPrintPreviewWidget::pagesCountChanged, q, [this] {
+        resetThumbnails();
+    });
+    QObject::connect(thumbnailWatcher, &QFutureWatcherBase::finished, q, [this, q] {
+        // 缩略图生成期间页面列表发生变化时丢弃结果
+        const QString &signature = thumbnailWatcher->property("_d_thumbnail_signature").toString();
+        if (signature == thumbnailSignature && thumbnailRow >= 0 && thumbnailRow < thumbnailModel->rowCount()) {
+            QStandardItem *item = thumbnailModel->item(thumbnailRow);
+            item->setIcon(QIcon(QPixmap::fromImage(thumbnailWatcher->result())));
+            item->setData(true, Qt::UserRole);
+        }
+
+        thumbnailRow = -1;
+        thumbnailTimer.start(0, q);
+    });
+}
+
+void DPrintPreviewWidgetPrivate::resetThumbnails()
+{
+    Q_Q(DPrintPreviewWidget);
+
+    if (!thumbnailView || !thumbnailView->isVisibleTo(q))
+        return;
+
+    const int sheetCount = pagesCount();
+    const QString signature = QStringLiteral("%1|%2|%3|%4|%5").arg(sheetCount).arg(imposition).arg(order).arg(previewGeneration).arg(qHash(pageRange));
+    if (signature != thumbnailSignature) {
+        thumbnailSignature = signature;
+        thumbnailModel->clear();
+        for (int i = 0; i < sheetCount; ++i) {
+            QStandardItem *item = new QStandardItem(QString::number(i + 1));
+            item->setTextAlignment(Qt::AlignCenter);
+            thumbnailModel->appendRow(item);
+        }
+    }
+
+    if (currentPageNumber > 0 && currentPageNumber <= thumbnailModel->rowCount()) {
+        const QModelIndex &index = thumbnailModel->index(currentPageNumber - 1, 0);
+        thumbnailView->setCurrentIndex(index);
+        thumbnailView->scrollTo(index);
+    }
+
+    thumbnailTimer.start(0, q);
+}
+
+int DPrintPreviewWidgetPrivate::nextThumbnailRow()
+{
+    const int rowCount = thumbnailModel->rowCount();
+    if (rowCount == 0)
+        return -1;
+
+    // 缩略图自上而下排列，二分查找第一个与视口相交的行；视图还未布局时各行区域为空，视为都不可见
+    const QRect &viewportRect = thumbnailView->viewport()->rect();
+    int first = 0;
+    int end = rowCount;
+    while (first < end) {
+        const int middle = (first + end) / 2;
+        if (thumbnailView->visualRect(thumbnailModel->index(middle, 0)).bottom() < viewportRect.top()) {
+            first = middle + 1;
+        } else {
+            end = middle;
+        }
+    }
+
+    for (int row = first; row < rowCount; ++row) {
+        if (!thumbnailView->visualRect(thumbnailModel->index(row, 0)).intersects(viewportRect))
+            break;
+
+        if (!thumbnailModel->item(row)->data(Qt::UserRole).toBool())
+            return row;
+    }
+
+    // 不可见的缩略图仅在页面数据已经存在时生成，异步模式下不为其单独请求页面
+    for (int row = 0; row < rowCount; ++row) {
+        if (thumbnailModel->item(row)->data(Qt::UserRole).toBool())
+            continue;
+
+        if (!isAsynPreview)
+            return row;
+
+        const QVector<int> &sourcePages = sheetSourcePages(row + 1);
+        bool cached = !sourcePages.isEmpty();
+        for (int page : sourcePages)
+            cached = cached && pageCache.contains(page);
+        if (cached)
+            return row;
+    }
+
+    return -1;
+}
+
+void DPrintPreviewWidgetPrivate::renderNextThumbnail()
+{
+    Q_Q(DPrintPreviewWidget);
+
+    if (!thumbnailView || !thumbnailView->isVisibleTo(q) || thumbnailWatcher->isRunning())
+        return;
+
+    const int row = nextThumbnailRow();
+    if (row < 0)
+        return;
+
+    const QVector<int> &sourcePages = sheetSourcePages(row + 1);
+    QList<QPicture> sheetPictures;
+    if (isAsynPreview) {
+        sheetPictures = fetchPreviewPages(sourcePages);
+    } else {
+        for (int page : sourcePages) {
+            if (page > 0 && page <= pictures.count())
+                sheetPictures.append(*pictures.at(page - 1));
+        }
+    }
+
+    // QPicture 回放时会修改共享数据，后台线程使用独立的深拷贝
+    for (QPicture &picture : sheetPictures)
+        picture.detach();
+
+    const QSize paperSize = previewPrinter->pageLayout().fullRectPixels(previewPrinter->resolution()).size();
+    const QRect pageRect = previewPrinter->pageLayout().paintRectPixels(previewPrinter->resolution());
+    const bool isNumberUp = imposition != DPrintPreviewWidget::One && numberUpPrintData;
+    const qreal scaleRatio = isNumberUp ? numberUpPrintData->scaleRatio : 1.0;
+    const QVector<QPointF> paintPoints = isNumberUp ? numberUpPrintData->paintPoints : QVector<QPointF>();
+    const QSize thumbnailSize = paperSize.scaled(PREVIEW_THUMBNAIL_WIDTH, PREVIEW_THUMBNAIL_WIDTH, Qt::KeepAspectRatio);
+
+    thumbnailRow = row;
+    thumbnailWatcher->setProperty("_d_thumbnail_signature", thumbnailSignature);
+    thumbnailWatcher->setFuture(QtConcurrent::run(QThreadPool::globalInstance(), [=]() -> QImage {
+        QImage thumbnail(thumbnailSize, QImage::Format_ARGB32_Premultiplied);
+        thumbnail.fill(Qt::white);
+        if (paperSize.isEmpty() || sheetPictures.isEmpty())
+            return thumbnail;
+
+        QPainter painter(&thumbnail);
+        painter.setRenderHint(QPainter::Antialiasing);
+        painter.setRenderHint(QPainter::SmoothPixmapTransform);
+        painter.scale(qreal(thumbnailSize.width()) / paperSize.width(), qreal(thumbnailSize.height()) / paperSize.height());
+        painter.setClipRect(pageRect);
+        painter.translate(pageRect.topLeft());
+        if (isNumberUp) {
+            drawMultiPageContent(&painter, pageRect.size(), 1.0, scaleRatio, paintPoints, sheetPictures, QPointF(0, 0), QImage());
+        } else {
+            painter.drawPicture(0, 0, sheetPictures.first());
+        }
+        painter.end();
+
+        return thumbnail;
+    }));
+}
+
 QVector<int> DPrintPreviewWidgetPrivate::requestPages(int page)
 {
     QVector<int> pagesVector;
@@ -1219,6 +1868,8 @@ DPrintPreviewWidget::~DPrintPreviewWidget()
     Q_D(DPrintPreviewWidget);
 
     d->updateTimer.stop();
+    d->prefetchTimer.stop();
+    d->thumbnailTimer.stop();
     delete d->numberUpPrintData;
 }
 
@@ -1859,6 +2510,14 @@ DPrintPreviewWidget::Order DPrintPreviewWidget::order() const
     return d->order;
 }
 
+/*!
+  \brief 设置按照文件路径打印的文件.
+
+  打印时 print 会先复制该文件，再在工作线程中将副本提交给cups，因此文件只需要在
+  print 返回之前保持可读，之后可以删除或覆盖。提交的结果通过 printJobSubmitted 或
+  printJobFailed 信号通知，控件销毁后不再通知，但任务仍会完成提交。
+  \a path 文件路径.
+ */
 void DPrintPreviewWidget::setPrintFromPath(const QString &path)
 {
     Q_D(DPrintPreviewWidget);
@@ -1885,6 +2544,7 @@ void DPrintPreviewWidget::setAsynPreview(int totalPage)
 
     d->isAsynPreview = true;
     d->asynPreviewTotalPage = totalPage;
+    d->pageCache.clear();
 }
 
 bool DPrintPreviewWidget::isAsynPreview() const
@@ -1894,6 +2554,44 @@ bool DPrintPreviewWidget::isAsynPreview() const
     return d->isAsynPreview;
 }
 
+/*!
+  \brief 设置是否显示页面缩略图列表。
+
+  缩略图列表显示在预览区域左侧，缩略图在空闲时于后台逐个生成，优先生成可见范围内的页面，
+  并优先复用已经渲染过的页面数据。异步预览模式下，不可见的页面不会单独请求数据。
+  点击缩略图可跳转到对应页面。
+
+  \a visible 是否显示缩略图列表
+ */
+void DPrintPreviewWidget::setThumbnailBarVisible(bool visible)
+{
+    Q_D(DPrintPreviewWidget);
+
+    if (!d->thumbnailView) {
+        if (!visible)
+            return;
+
+        d->initThumbnailBar();
+    }
+
+    d->thumbnailView->setVisible(visible);
+    if (visible) {
+        d->resetThumbnails();
+    } else {
+        d->thumbnailTimer.stop();
+    }
+}
+
+/*!
+  \brief 获取是否显示页面缩略图列表。
+ */
+bool DPrintPreviewWidget::isThumbnailBarVisible() const
+{
+    D_DC(DPrintPreviewWidget);
+
+    return d->thumbnailView && d->thumbnailView->isVisibleTo(this);
+}
+
 void DPrintPreviewWidget::isPageByPage(int pageCopy, bool isFirst)
 {
     Q_D(DPrintPreviewWidget);
@@ -2003,6 +2701,8 @@ void DPrintPreviewWidget::setCurrentPage(int page)
     if (d->isAsynPreview) {
         d->previewPages = d->requestPages(page);
         d->generatePreviewPicture();
+        // 当前页显示后再空闲预取相邻页面，首页显示时间不受文档长度影响
+        d->prefetchTimer.start(0, this);
     }
 
     if (d->imposition != Imposition::One) {
@@ -2017,13 +2717,19 @@ void DPrintPreviewWidget::print(bool isSavedPicture)
     Q_D(DPrintPreviewWidget);
     Q_UNUSED(isSavedPicture);
 
+    // 导出PDF期间会处理事件，此时再次开始打印会打断正在进行的导出
+    if (d->exporting) {
+        qWarning() << "Ignore print request while exporting";
+        return;
+    }
+
     switch (d->printMode) {
     case PrintToPrinter:
         if (d->printFromPath.isEmpty()) {
             // 通过QPrinter打印
             d->print(false);
         } else {
-            // 通过cups打印
+            // 通过cups异步提交打印任务
             d->printByCups();
         }
 
@@ -2037,6 +2743,20 @@ void DPrintPreviewWidget::print(bool isSavedPicture)
     }
 }
 
+/*!
+  \brief 取消正在进行的PDF导出。
+
+  异步预览模式下导出PDF时会分批请求页面数据，每一批完成后发送 exportProgress
+  信号并处理一次事件，可在该信号的响应中或导出期间投递的事件(如取消按钮)中调用此函数
+  取消导出，已生成的文件会被删除。导出期间再次调用 print 会被忽略。
+ */
+void DPrintPreviewWidget::cancelExport()
+{
+    Q_D(DPrintPreviewWidget);
+
+    d->exportCanceled = true;
+}
+
 void DPrintPreviewWidget::themeTypeChanged(DGuiApplicationHelper::ColorType themeType)
 {
     Q_D(DPrintPreviewWidget);
@@ -2049,11 +2769,23 @@ void DPrintPreviewWidget::themeTypeChanged(DGuiApplicationHelper::ColorType them
 void DPrintPreviewWidget::timerEvent(QTimerEvent *event)
 {
     Q_D(DPrintPreviewWidget);
+
+    // 导出期间预览数据正在使用，定时任务留到导出结束后执行
+    if (d->exporting)
+        return;
+
     if (event->timerId() == d->updateTimer.timerId()) {
         if (d->updateTimer.isActive()) {
             d->updateTimer.stop();
             d->updatePreview();
         }
+    } else if (event->timerId() == d->prefetchTimer.timerId()) {
+        d->prefetchTimer.stop();
+        d->prefetchNeighbourPages();
+    } else if (event->timerId() == d->thumbnailTimer.timerId()) {
+        // 缩略图在空闲时逐个生成，优先级低于页面预览
+        d->thumbnailTimer.stop();
+        d->renderNextThumbnail();
     }
 
     return DFrame::timerEvent(event);
@@ -2119,7 +2851,7 @@ void ContentItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *item,
 
     if (pwidget && (pwidget->getColorMode() == QPrinter::GrayScale)) {
         // 图像灰度处理
-        painter->drawPicture(0, 0, grayPicture);
+        painter->drawImage(0, 0, grayscaleImage());
     } else if (pwidget && (pwidget->getColorMode() == QPrinter::Color)) {
         drawNumberUpPictures(painter);
     }
@@ -2127,7 +2859,24 @@ void ContentItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *item,
 
 void ContentItem::updateGrayContent()
 {
-    grayPicture = grayscalePaint(*pagePicture);
+    // 灰度内容按页码和分辨率缓存，仅在灰度模式下绘制时生成，这里只需刷新显示
+    update();
+}
+
+QImage ContentItem::grayscaleImage()
+{
+    DPrintPreviewWidget *pwidget = qobject_cast<DPrintPreviewWidget *>(scene()->parent()->parent());
+    DPrintPreviewWidgetPrivate *d = pwidget->d_func();
+    const QString &key = d->grayscaleCacheKey();
+    if (QImage *image = d->grayscaleCache.object(key))
+        return *image;
+
+    const QImage &grayImage = grayscalePaint(*pagePicture);
+    // 以 KB 为单位计算缓存开销
+    const int cost = qMax<qint64>(1, static_cast<qint64>(grayImage.width()) * grayImage.height() * grayImage.depth() / 8 / 1024);
+    d->grayscaleCache.insert(key, new QImage(grayImage), cost);
+
+    return grayImage;
 }
 
 void ContentItem::drawNumberUpPictures(QPainter *painter)
@@ -2145,22 +2894,56 @@ void ContentItem::drawNumberUpPictures(QPainter *painter)
         return;
     }
 
-    qreal scaleRatio = pwidget->d_func()->numberUpPrintData->scaleRatio;
-    const QVector<QPair<int, const QPicture *>> &numberUpPictures = pwidget->d_func()->numberUpPrintData->previewPictures;
-    const QVector<QPointF> paintPoints = pwidget->d_func()->numberUpPrintData->paintPoints;
+    DPrintPreviewWidgetPrivate *d = pwidget->d_func();
+    // 按最终绘制到设备上的缩放比例缓存拼接好的页面，翻页或无关设置改变时不再重复绘制每个小页面
+    const QTransform &transform = painter->worldTransform();
+    const qreal deviceScale = qRound(qSqrt(qAbs(transform.determinant())) * painter->device()->devicePixelRatioF() * 100) / 100.0;
+    const QString &key = d->numberUpSheetKey(deviceScale);
+    const QRectF targetRect(QPointF(0, 0), QSizeF(pageRect.size()));
 
-    painter->save();
-    painter->scale(scaleRatio, scaleRatio);
-    for (int c = 0; c < numberUpPictures.count(); ++c) {
-        QPointF paintPoint = paintPoints.at(c) / scaleRatio;
-        const QPicture *pic = numberUpPictures.at(c).second;
-        painter->drawPicture(paintPoint, *pic);
+    if (QImage *sheet = d->numberUpSheetCache.object(key)) {
+        painter->drawImage(targetRect, *sheet);
+        return;
     }
 
-    painter->restore();
+    const QSize sheetSize = (QSizeF(pageRect.size()) * deviceScale).toSize();
+    if (sheetSize.isEmpty())
+        return;
+
+    qreal scaleRatio = d->numberUpPrintData->scaleRatio;
+    const QVector<QPair<int, const QPicture *>> &numberUpPictures = d->numberUpPrintData->previewPictures;
+    const QVector<QPointF> paintPoints = d->numberUpPrintData->paintPoints;
+    auto drawPictures = [&](QPainter *p) {
+        for (int c = 0; c < numberUpPictures.count(); ++c) {
+            QPointF paintPoint = paintPoints.at(c) / scaleRatio;
+            const QPicture *pic = numberUpPictures.at(c).second;
+            p->drawPicture(paintPoint, *pic);
+        }
+    };
+
+    // 以 KB 为单位计算缓存开销，放大或高分屏下超出缓存上限时无法缓存，直接回放页面数据，只绘制需要更新的区域
+    const qint64 cost = qMax<qint64>(1, static_cast<qint64>(sheetSize.width()) * sheetSize.height() * 4 / 1024);
+    if (cost > d->numberUpSheetCache.maxCost()) {
+        painter->save();
+        painter->scale(scaleRatio, scaleRatio);
+        drawPictures(painter);
+        painter->restore();
+        return;
+    }
+
+    QImage sheet(sheetSize, QImage::Format_ARGB32_Premultiplied);
+    sheet.fill(Qt::transparent);
+    QPainter sheetPainter(&sheet);
+    sheetPainter.setRenderHints(painter->renderHints());
+    sheetPainter.scale(deviceScale * scaleRatio, deviceScale * scaleRatio);
+    drawPictures(&sheetPainter);
+    sheetPainter.end();
+
+    painter->drawImage(targetRect, sheet);
+    d->numberUpSheetCache.insert(key, new QImage(sheet), static_cast<int>(cost));
 }
 
-QPicture ContentItem::grayscalePaint(const QPicture &picture)
+QImage ContentItem::grayscalePaint(const QPicture &picture)
 {
     Q_UNUSED(picture);
 
@@ -2172,30 +2955,25 @@ QPicture ContentItem::grayscalePaint(const QPicture &picture)
     drawNumberUpPictures(&imageP);
     imageP.end();
 
-    image = imageGrayscale(&image);
-
-    QPicture temp;
-    QPainter tempP;
-
-    tempP.begin(&temp);
-    tempP.drawImage(0, 0, image);
-    tempP.end();
-
-    return temp;
+    // 直接返回图像，避免再次序列化到 QPicture 中
+    return imageGrayscale(&image);
 }
 
 QImage ContentItem::imageGrayscale(const QImage *origin)
 {
-    int w = origin->width();
-    int h = origin->height();
+    const QImage source = origin->format() == QImage::Format_ARGB32 ? *origin : origin->convertToFormat(QImage::Format_ARGB32);
+    const int w = source.width();
+    const int h = source.height();
     QImage iGray(w, h, QImage::Format_ARGB32);
 
-    for (int i = 0; i < w; i++) {
-        for (int j = 0; j < h; j++) {
-            QRgb pixel = origin->pixel(i, j);
-            int gray = qGray(pixel);
-            QColor color(gray, gray, gray, qAlpha(pixel));
-            iGray.setPixel(i, j, color.rgba());
+    // 按行访问原始数据，灰度权重与 qGray 保持一致并保留透明度
+    for (int y = 0; y < h; ++y) {
+        const QRgb *src = reinterpret_cast<const QRgb *>(source.constScanLine(y));
+        QRgb *dst = reinterpret_cast<QRgb *>(iGray.scanLine(y));
+        for (int x = 0; x < w; ++x) {
+            const QRgb pixel = src[x];
+            const int gray = qGray(pixel);
+            dst[x] = qRgba(gray, gray, gray, qAlpha(pixel));
         }
     }
 
@@ -2268,24 +3046,31 @@ void WaterMark::updatePicture(QPainter *painter, bool isPreview)
         }
 
         QSize spaceSize = QSize(columnSpace, rowSpace) * numberUpScale * wScale;
-        QImage textImage(textSize + spaceSize, QImage::Format_ARGB32);
-        textImage.fill(Qt::transparent);
-        QPainter tp;
-        tp.begin(&textImage);
-
-        tp.setFont(font);
-        tp.setPen(color);
-        tp.setBrush(Qt::NoBrush);
-        tp.setRenderHint(QPainter::TextAntialiasing);
-        tp.drawText(textImage.rect(), Qt::AlignBottom | Qt::AlignRight, text);
-        tp.end();
+        // 纹理只与字体、颜色、文本和间距有关，预览和打印时参数未变化则直接复用
+        const QString tileKey = QStringLiteral("%1|%2|%3|%4x%5").arg(font.toString()).arg(color.rgba()).arg(text).arg(spaceSize.width()).arg(spaceSize.height());
+        if (tileKey != textTileKey) {
+            QImage textImage(textSize + spaceSize, QImage::Format_ARGB32);
+            textImage.fill(Qt::transparent);
+            QPainter tp;
+            tp.begin(&textImage);
+
+            tp.setFont(font);
+            tp.setPen(color);
+            tp.setBrush(Qt::NoBrush);
+            tp.setRenderHint(QPainter::TextAntialiasing);
+            tp.drawText(textImage.rect(), Qt::AlignBottom | Qt::AlignRight, text);
+            tp.end();
+
+            textTileImage = textImage;
+            textTileKey = tileKey;
+        }
 
         painter->save();
         painter->setRenderHint(QPainter::SmoothPixmapTransform);
         painter->setRenderHint(QPainter::Antialiasing);
         painter->setPen(Qt::NoPen);
         QBrush b;
-        b.setTextureImage(textImage);
+        b.setTextureImage(textTileImage);
         painter->setBrush(b);
         painter->drawRect(twoPolygon.boundingRect());
         painter->restore();
@@ -48,4 +48,27 @@ DSimpleListItem::DSimpleListItem()
 
 }
 
+/*!
+  \brief identityKey 返回列表项的标识.
+
+  标识相同且不为 0 的两个列表项被视为同一项，DSimpleListView 刷新时通过哈希查找恢复选中状态，
+  不再对每个选中项调用 sameAs.
+  \return 列表项的标识，返回 0 表示没有标识，此时使用 sameAs 进行比较，默认返回 0.
+ */
+quint64 DSimpleListItem::identityKey() const
+{
+    return 0;
+}
+
+/*!
+  \brief contentVersion 返回列表项绘制内容的版本.
+
+  DSimpleListView::refreshItems 只重绘标识或内容版本发生变化的可见行.
+  \return 内容版本，返回 0 表示未知，此时该行总是会被重绘，默认返回 0.
+ */
+quint64 DSimpleListItem::contentVersion() const
+{
+    return 0;
+}
+
 DWIDGET_END_NAMESPACE
@@ -14,11 +14,101 @@
 #include <QtMath>
 #include <QPointer>
 #include <QPainterPath>
+#include <QPaintEvent>
+#include <QHash>
+#include <QSet>
+#include <QCache>
+#include <QVector>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <atomic>
 
 DCORE_USE_NAMESPACE
 DGUI_USE_NAMESPACE
 DWIDGET_BEGIN_NAMESPACE
 
+// 超过该数量的列表项在后台线程中搜索
+static const int BackgroundSearchThreshold = 10000;
+// 超过该数量的列表项分段并行排序
+static const int ParallelSortThreshold = 20000;
+
+template<typename Iterator, typename Compare>
+static void sortItems(Iterator begin, Iterator end, Compare compare, bool stable)
+{
+    if (stable) {
+        std::stable_sort(begin, end, compare);
+    } else {
+        std::sort(begin, end, compare);
+    }
+}
+
+template<typename Iterator, typename Compare>
+static void parallelSortItems(Iterator begin, Iterator end, Compare compare, bool stable)
+{
+    const int count = static_cast<int>(end - begin);
+    const int chunkCount = std::min(QThreadPool::globalInstance()->maxThreadCount(), count / (ParallelSortThreshold / 2));
+
+    if (count < ParallelSortThreshold || chunkCount < 2) {
+        sortItems(begin, end, compare, stable);
+        return;
+    }
+
+    QVector<Iterator> bounds;
+    for (int i = 0; i < chunkCount; ++i)
+        bounds << begin + static_cast<qint64>(count) * i / chunkCount;
+    bounds << end;
+
+    // 各段分别排序，再两两归并；inplace_merge 是稳定的，各段稳定排序时整体也是稳定的
+    QVector<QFuture<void>> futures;
+    for (int i = 0; i + 1 < bounds.count(); ++i) {
+        futures << QtConcurrent::run(QThreadPool::globalInstance(), [=] {
+            sortItems(bounds.at(i), bounds.at(i + 1), compare, stable);
+        });
+    }
+    for (QFuture<void> &future : futures)
+        future.waitForFinished();
+
+    while (bounds.count() > 2) {
+        QVector<Iterator> mergedBounds;
+        futures.clear();
+
+        for (int i = 0; i + 2 < bounds.count(); i += 2) {
+            futures << QtConcurrent::run(QThreadPool::globalInstance(), [=] {
+                std::inplace_merge(bounds.at(i), bounds.at(i + 1), bounds.at(i + 2), compare);
+            });
+            mergedBounds << bounds.at(i);
+        }
+
+        // 段数为奇数时最后一段留到下一轮归并
+        if (bounds.count() % 2 == 0)
+            mergedBounds << bounds.at(bounds.count() - 2);
+        mergedBounds << bounds.last();
+
+        for (QFuture<void> &future : futures)
+            future.waitForFinished();
+
+        bounds = mergedBounds;
+    }
+}
+
+static QList<DSimpleListItem*> filterSearchItems(const QList<DSimpleListItem*> &items, SearchAlgorithm algorithm,
+                                                 const QString &content, const std::atomic_bool *canceled = nullptr)
+{
+    QList<DSimpleListItem*> searchItems;
+
+    for (int i = 0; i < items.count(); ++i) {
+        // 每处理一批列表项检查一次是否已被新的搜索取代
+        if (canceled && (i & 0x3ff) == 0 && canceled->load(std::memory_order_relaxed))
+            return QList<DSimpleListItem*>();
+
+        if (algorithm(items.at(i), content))
+            searchItems.append(items.at(i));
+    }
+
+    return searchItems;
+}
+
 class DSimpleListViewPrivate : public DTK_CORE_NAMESPACE::DObjectPrivate
 {
 public:
@@ -28,9 +118,42 @@ public:
     }
 
     QList<DSimpleListItem*> getSearchItems(QList<DSimpleListItem*> items);
+    void startSearch(const QList<DSimpleListItem*> &items, const QString &content);
+    void finishSearch(const QList<DSimpleListItem*> &items, const QString &content, quint32 generation);
+    void cancelSearch();
+    void waitForSearch();
     int getItemsTotalHeight();
     int getTopRenderOffset();
     void sortItemsByColumn(int column, bool descendingSort);
+    void restorePreviousOrder(const QHash<quint64, int> &previousRows, int previousCount);
+    void takeSortedPrefix(int column, bool descendingSort);
+    bool canSort() const;
+
+    struct RowState
+    {
+        int row = -1;
+        quint64 key = 0;
+        quint64 version = 0;
+        bool isSelect = false;
+        bool isHover = false;
+
+        bool isSameContent(const RowState &other) const
+        {
+            // 未提供标识或版本的行无法判断内容是否变化
+            return row == other.row && key != 0 && version != 0
+                    && key == other.key && version == other.version
+                    && isSelect == other.isSelect && isHover == other.isHover;
+        }
+    };
+
+    int rowAt(int y) const;
+    QVector<RowState> visibleRowStates();
+    int renderRowOf(DSimpleListItem *item);
+    void markRenderItemsChanged();
+    void requestUpdate();
+    void drawRowForeground(QPainter *painter, DSimpleListItem *item, int y, int index, bool isSelect, bool isHover, const QList<int> &renderWidths);
+    QPixmap rowForeground(DSimpleListItem *item, int index, bool isSelect, bool isHover, const QList<int> &renderWidths, const QPainter &viewPainter);
+    void requestUpdate(const QRegion &region);
 
     QPointer<DSimpleListItem> lastHoverItem = nullptr;
     QPointer<DSimpleListItem> lastSelectItem = nullptr;
@@ -39,11 +162,49 @@ public:
     QList<DSimpleListItem*> *listItems = nullptr;
     QList<DSimpleListItem*> *renderItems = nullptr;
     QList<DSimpleListItem*> *selectionItems = nullptr;
+    // 与 renderItems/selectionItems 同步的索引，避免绘制和选择时遍历整个列表
+    QHash<DSimpleListItem*, int> renderRows;
+    QSet<DSimpleListItem*> selectionSet;
+    bool renderRowsDirty = true;
     QList<QString> columnTitles = {};
     QList<SortAlgorithm> *sortingAlgorithms = nullptr;
     QList<bool> *sortingOrderes = nullptr;
     QList<int> columnWidths = {};
     QString searchContent = "";
+    // renderItems 对应的搜索内容，为 null 时表示 renderItems 不是一次完整搜索的结果
+    QString renderedSearchContent = "";
+    // 被取消的搜索不等待其结束，只丢弃结果；删除列表项之前才需要等待全部结束
+    QList<QFuture<void>> searchFutures;
+    QSharedPointer<std::atomic_bool> searchCanceled;
+    quint32 searchGeneration = 0;
+    bool searchPending = false;
+    bool incrementalSearch = false;
+    bool backgroundSearch = false;
+    // renderItems 前 sortedCount 项已按 sortedColumn/sortedDescending 排好序
+    int sortedCount = 0;
+    int sortedColumn = -1;
+    bool sortedDescending = false;
+    bool stableSort = false;
+    bool parallelSort = false;
+    // beginUpdate/endUpdate 之间的重绘请求合并到一起
+    int updateBatchDepth = 0;
+    bool pendingFullUpdate = false;
+    QRegion pendingUpdateRegion;
+
+    // 以 DSimpleListItem::identityKey 为键缓存的行前景，内容版本、列宽等变化时重新绘制
+    struct RowCacheEntry
+    {
+        quint64 version = 0;
+        QList<int> renderWidths;
+        qreal devicePixelRatio = 1;
+        qreal opacity = 1;
+        int index = -1;
+        bool isSelect = false;
+        bool isHover = false;
+        QPixmap pixmap;
+    };
+    QCache<quint64, RowCacheEntry> rowCache;
+    bool rowCacheEnabled = false;
     QTimer *hideScrollbarTimer = nullptr;
     SearchAlgorithm searchAlgorithm = nullptr;
     bool defaultSortingOrder = false;
@@ -151,7 +312,11 @@ DSimpleListView::DSimpleListView(QWidget *parent) : QWidget(parent), DObject(*ne
     d->oldRenderOffset = 0;
     d->clipRadius = 0;
 
-    d->hideScrollbarTimer = NULL;
+    d->rowCache.setMaxCost(16 * 1024); // 16 MB
+
+    d->hideScrollbarTimer = new QTimer(this);
+    d->hideScrollbarTimer->setSingleShot(true);
+    connect(d->hideScrollbarTimer, SIGNAL(timeout()), this, SLOT(hideScrollbar()));
 
     d->sortingAlgorithms = new QList<SortAlgorithm>();
     d->sortingOrderes = new QList<bool>();
@@ -161,6 +326,8 @@ DSimpleListView::~DSimpleListView()
 {
     D_D(DSimpleListView);
 
+    d->waitForSearch();
+
     delete d->lastHoverItem.data();
     delete d->lastSelectItem.data();
     delete d->drawHoverItem.data();
@@ -170,7 +337,6 @@ DSimpleListView::~DSimpleListView()
     delete d->selectionItems;
     delete d->sortingAlgorithms;
     delete d->sortingOrderes;
-    delete d->hideScrollbarTimer;
 }
 
 /*!
@@ -249,6 +415,7 @@ void DSimpleListView::setColumnSortingAlgorithms(QList<SortAlgorithm> *algorithm
 
     // Add sort algorithms.
     d->sortingAlgorithms = algorithms;
+    d->sortedCount = 0;
 
     for (int i = 0; i < d->sortingAlgorithms->count(); i++) {
         d->sortingOrderes->append(false);
@@ -312,6 +479,13 @@ void DSimpleListView::addItems(QList<DSimpleListItem*> items)
     d->listItems->append(items);
     QList<DSimpleListItem*> searchItems = d->getSearchItems(items);
     d->renderItems->append(searchItems);
+    d->markRenderItemsChanged();
+
+    // The pending search doesn't know new items, search again with all items.
+    if (d->searchPending) {
+        d->renderedSearchContent = QString();
+        d->startSearch(*d->listItems, d->searchContent);
+    }
 
     // If user has click title to sort, sort items after add items to list.
     if (d->defaultSortingColumn != -1) {
@@ -319,7 +493,7 @@ void DSimpleListView::addItems(QList<DSimpleListItem*> items)
     }
 
     // Repaint after add items.
-    repaint();
+    d->requestUpdate();
 }
 
 /*!
@@ -331,14 +505,32 @@ void DSimpleListView::removeItem(DSimpleListItem* item)
 {
     D_D(DSimpleListView);
 
+    // 调用者可能在移除后删除列表项，需要等待正在读取它的后台搜索结束
+    d->waitForSearch();
     d->listItems->removeOne(item);
-    d->renderItems->removeOne(item);
+
+    // Remove item don't break the order of sorted items.
+    int row = d->renderItems->indexOf(item);
+    if (row >= 0) {
+        d->renderItems->removeAt(row);
+        if (row < d->sortedCount) {
+            --d->sortedCount;
+        }
+    }
+    d->markRenderItemsChanged();
+
+    if (d->searchPending) {
+        d->startSearch(*d->listItems, d->searchContent);
+    }
+
+    if (d->selectionItems->removeOne(item))
+        d->selectionSet.remove(item);
 
     if (d->renderOffset >= d->getItemsTotalHeight() - rect().height()) {
         d->renderOffset = adjustRenderOffset(d->renderOffset - d->rowHeight);
     }
 
-    repaint();
+    d->requestUpdate();
 }
 
 /*!
@@ -348,11 +540,17 @@ void DSimpleListView::clearItems()
 {
     D_D(DSimpleListView);
 
+    // Background search is reading items, stop it before delete items.
+    d->waitForSearch();
+    d->renderedSearchContent = d->searchContent;
+
     // NOTE:
     // We need delete items in QList before clear QList to avoid *MEMORY LEAK* .
     qDeleteAll(d->listItems->begin(), d->listItems->end());
     d->listItems->clear();
     d->renderItems->clear();
+    d->sortedCount = 0;
+    d->markRenderItemsChanged();
 }
 
 /*!
@@ -366,6 +564,8 @@ void DSimpleListView::addSelections(QList<DSimpleListItem*> items, bool recordLa
 
     // Add item to selection list.
     d->selectionItems->append(items);
+    for (DSimpleListItem *item : items)
+        d->selectionSet.insert(item);
 
     // Record last selection item to make selected operation continuously.
     if (recordLastSelection && d->selectionItems->count() > 0) {
@@ -384,6 +584,7 @@ void DSimpleListView::clearSelections(bool clearLastSelection)
 
     // Clear selection list.
     d->selectionItems->clear();
+    d->selectionSet.clear();
 
     if (clearLastSelection) {
         d->lastSelectItem = NULL;
@@ -405,6 +606,8 @@ QList<DSimpleListItem*> DSimpleListView::getSelections()
 /*!
   \brief 刷新所有项.
 
+  设置了默认排序列时，提供了 DSimpleListItem::identityKey 的列表项先按上次刷新中的位置
+  放回，只有新增或排序结果变化的列表项才会重新排序后归并.
   \a items 列表项.
  */
 void DSimpleListView::refreshItems(QList<DSimpleListItem*> items)
@@ -412,34 +615,64 @@ void DSimpleListView::refreshItems(QList<DSimpleListItem*> items)
     D_D(DSimpleListView);
 
     // Init.
-    QList<DSimpleListItem*> *newSelectionItems = new QList<DSimpleListItem*>();
+    QList<DSimpleListItem*> newSelectionItems;
     DSimpleListItem *newLastSelectionItem = NULL;
     DSimpleListItem *newLastHoverItem = NULL;
 
+    // Record visible rows to repaint changed rows only.
+    const int oldRowCount = d->renderItems->count();
+    const int oldRenderOffset = d->renderOffset;
+    const QVector<DSimpleListViewPrivate::RowState> oldRows = d->visibleRowStates();
+
+    // Record rows of items to restore the sorted order of unchanged items across refreshes.
+    QHash<quint64, int> previousRows;
+    if (d->defaultSortingColumn != -1 && d->canSort()) {
+        previousRows.reserve(d->renderItems->count());
+        for (int i = 0; i < d->renderItems->count(); ++i) {
+            if (quint64 key = d->renderItems->at(i)->identityKey()) {
+                previousRows.insert(key, i);
+            }
+        }
+    }
+
     // Save selection items and last selection item.
+    // Items with identity key are matched by hash lookup, others fall back to sameAs.
+    QSet<quint64> selectionKeys;
+    QList<DSimpleListItem*> unkeyedSelectionItems;
+    for (DSimpleListItem *selectionItem:*d->selectionItems) {
+        if (quint64 key = selectionItem->identityKey()) {
+            selectionKeys.insert(key);
+        } else {
+            unkeyedSelectionItems.append(selectionItem);
+        }
+    }
+
+    const quint64 lastSelectKey = d->lastSelectItem ? d->lastSelectItem->identityKey() : 0;
+    const quint64 lastHoverKey = d->lastHoverItem ? d->lastHoverItem->identityKey() : 0;
+
     for (DSimpleListItem *item:items) {
-        for (DSimpleListItem *selectionItem:*d->selectionItems) {
-            if (item->sameAs(selectionItem)) {
-                newSelectionItems->append(item);
-                break;
+        const quint64 key = item->identityKey();
+
+        if (key != 0 && selectionKeys.contains(key)) {
+            newSelectionItems.append(item);
+        } else {
+            for (DSimpleListItem *selectionItem:unkeyedSelectionItems) {
+                if (item->sameAs(selectionItem)) {
+                    newSelectionItems.append(item);
+                    break;
+                }
             }
         }
-    }
 
-    if (d->lastSelectItem != NULL) {
-        for (DSimpleListItem *item:items) {
-            if (item->sameAs(d->lastSelectItem)) {
+        if (d->lastSelectItem != NULL && newLastSelectionItem == NULL) {
+            if (lastSelectKey != 0 ? key == lastSelectKey : item->sameAs(d->lastSelectItem)) {
                 newLastSelectionItem = item;
-                break;
             }
         }
-    }
 
-    if (d->lastHoverItem != NULL) {
-        for (DSimpleListItem *item:items) {
-            if (item->sameAs(d->lastHoverItem)) {
+        if (d->lastHoverItem != NULL && newLastHoverItem == NULL) {
+            if (lastHoverKey != 0 ? key == lastHoverKey : item->sameAs(d->lastHoverItem)) {
                 newLastHoverItem = item;
-                break;
             }
         }
     }
@@ -450,15 +683,21 @@ void DSimpleListView::refreshItems(QList<DSimpleListItem*> items)
     d->listItems->append(items);
     QList<DSimpleListItem*> searchItems = d->getSearchItems(items);
     d->renderItems->append(searchItems);
+    d->markRenderItemsChanged();
 
     // Sort once if default sort column hasn't init.
+    // Unchanged items keep their previous order, only new or changed items are sorted and merged.
     if (d->defaultSortingColumn != -1) {
+        if (!previousRows.isEmpty()) {
+            d->restorePreviousOrder(previousRows, oldRowCount);
+            d->takeSortedPrefix(d->defaultSortingColumn, d->defaultSortingOrder);
+        }
         d->sortItemsByColumn(d->defaultSortingColumn, d->defaultSortingOrder);
     }
 
     // Restore selection items and last selection item.
     clearSelections();
-    addSelections(*newSelectionItems, false);
+    addSelections(newSelectionItems, false);
     d->lastSelectItem = newLastSelectionItem;
     d->lastHoverItem = newLastHoverItem;
 
@@ -466,7 +705,27 @@ void DSimpleListView::refreshItems(QList<DSimpleListItem*> items)
     d->renderOffset = adjustRenderOffset(d->renderOffset);
 
     // Render.
-    repaint();
+    // Scrollbar and empty search tooltip depend on row count and offset, repaint all if they changed.
+    if (oldRowCount != d->renderItems->count() || oldRenderOffset != d->renderOffset) {
+        d->requestUpdate();
+        return;
+    }
+
+    const QVector<DSimpleListViewPrivate::RowState> newRows = d->visibleRowStates();
+    QRegion dirtyRegion;
+
+    for (int i = 0; i < newRows.count(); ++i) {
+        const DSimpleListViewPrivate::RowState &row = newRows.at(i);
+
+        if (i < oldRows.count() && row.isSameContent(oldRows.at(i)))
+            continue;
+
+        dirtyRegion += QRect(0, d->titleHeight + row.row * d->rowHeight - d->renderOffset, rect().width(), d->rowHeight);
+    }
+
+    if (!dirtyRegion.isEmpty()) {
+        d->requestUpdate(dirtyRegion);
+    }
 }
 
 /*!
@@ -478,20 +737,175 @@ void DSimpleListView::search(QString content)
 {
     D_D(DSimpleListView);
 
-    if (content == "" && d->searchContent != content) {
-        d->searchContent = content;
+    // 新的搜索内容会取代还未完成的后台搜索
+    d->cancelSearch();
+    d->searchContent = content;
+
+    d->sortedCount = 0;
 
+    if (content == "" || d->searchAlgorithm == NULL) {
         d->renderItems->clear();
         d->renderItems->append(*d->listItems);
+        d->renderedSearchContent = content;
     } else {
-        d->searchContent = content;
+        // 搜索内容在上次的基础上追加时，只需要在上次的结果中继续过滤
+        const bool narrow = d->incrementalSearch && !d->renderedSearchContent.isEmpty()
+                && content.startsWith(d->renderedSearchContent);
+        const QList<DSimpleListItem*> sourceItems = narrow ? *d->renderItems : *d->listItems;
+
+        if (d->backgroundSearch && sourceItems.count() >= BackgroundSearchThreshold) {
+            d->startSearch(sourceItems, content);
+            return;
+        }
 
-        QList<DSimpleListItem*> searchItems = d->getSearchItems(*d->listItems);
-        d->renderItems->clear();
-        d->renderItems->append(searchItems);
+        *d->renderItems = filterSearchItems(sourceItems, d->searchAlgorithm, content);
+        d->renderedSearchContent = content;
+    }
+
+    d->markRenderItemsChanged();
+
+    d->requestUpdate();
+}
+
+/*!
+  \brief 设置是否启用增量搜索.
+
+  启用后，如果新的搜索内容以上次的搜索内容开头，只在上次的搜索结果中继续过滤，
+  要求搜索算法满足：匹配较长的搜索内容的列表项一定也匹配它的前缀（例如子串匹配）.
+  \a incremental 是否启用增量搜索，默认为 false.
+ */
+void DSimpleListView::setIncrementalSearch(bool incremental)
+{
+    D_D(DSimpleListView);
+
+    d->incrementalSearch = incremental;
+}
+
+/*!
+  \brief 设置是否在后台线程中搜索.
+
+  启用后列表项较多时搜索算法在线程池中执行，界面线程不会被阻塞，完成后一次性替换显示的列表项.
+  此时搜索算法必须是线程安全的：只能读取列表项自身的数据，不能访问控件或其他非线程安全的状态，
+  并且在搜索期间不能修改列表项.
+  \a background 是否在后台搜索，默认为 false.
+ */
+void DSimpleListView::setBackgroundSearch(bool background)
+{
+    D_D(DSimpleListView);
+
+    d->backgroundSearch = background;
+}
+
+/*!
+  \brief 设置是否使用稳定排序.
+
+  启用后排序结果相等的列表项保持原有的相对顺序，刷新时按照列表项的标识
+  (DSimpleListItem::identityKey) 保持它们在上次刷新中的相对顺序，避免相等的行来回跳动.
+  \a stable 是否使用稳定排序，默认为 false.
+ */
+void DSimpleListView::setStableSort(bool stable)
+{
+    D_D(DSimpleListView);
+
+    d->stableSort = stable;
+}
+
+/*!
+  \brief 设置是否并行排序.
+
+  启用后列表项较多时分段在线程池中排序后再归并，排序算法会在多个线程中同时调用，
+  必须是线程安全的：只能读取传入的列表项，不能访问控件或其他非线程安全的状态.
+  \a parallel 是否并行排序，默认为 false.
+ */
+void DSimpleListView::setParallelSort(bool parallel)
+{
+    D_D(DSimpleListView);
+
+    d->parallelSort = parallel;
+}
+
+/*!
+  \brief 是否有正在后台进行的搜索.
+
+  启用后台搜索 (setBackgroundSearch) 且列表项较多时搜索在后台线程中进行，完成后一次性替换显示的列表项.
+  \return 有未完成的搜索时返回 true.
+ */
+bool DSimpleListView::isSearching() const
+{
+    D_DC(DSimpleListView);
+
+    return d->searchPending;
+}
+
+/*!
+  \brief 设置是否缓存每一行绘制的前景.
+
+  启用后，提供了 DSimpleListItem::identityKey 和 DSimpleListItem::contentVersion 的列表项
+  绘制的前景会被缓存为图片，滚动或仅选中状态变化时直接绘制缓存的图片。
+  内容版本、列宽、设备像素比、字体或调色板变化时会重新绘制.
+  \a enable 是否启用行缓存，默认为 false.
+ */
+void DSimpleListView::setRowCacheEnabled(bool enable)
+{
+    D_D(DSimpleListView);
+
+    d->rowCacheEnabled = enable;
+
+    if (!enable) {
+        d->rowCache.clear();
+    }
+
+    d->requestUpdate();
+}
+
+/*!
+  \brief 清除行前景缓存.
+
+  列表项的绘制内容发生了变化但没有更新 DSimpleListItem::contentVersion 时，可以调用此函数强制重绘.
+ */
+void DSimpleListView::clearRowCache()
+{
+    D_D(DSimpleListView);
+
+    d->rowCache.clear();
+    d->requestUpdate();
+}
+
+/*!
+  \brief 开始批量更新.
+
+  在 beginUpdate 和 endUpdate 之间的所有修改只会在 endUpdate 时触发一次重绘，
+  可以嵌套调用，最外层的 endUpdate 才会触发重绘.
+  \sa endUpdate
+ */
+void DSimpleListView::beginUpdate()
+{
+    D_D(DSimpleListView);
+
+    ++d->updateBatchDepth;
+}
+
+/*!
+  \brief 结束批量更新，并重绘期间发生变化的区域.
+
+  \sa beginUpdate
+ */
+void DSimpleListView::endUpdate()
+{
+    D_D(DSimpleListView);
+
+    if (d->updateBatchDepth == 0 || --d->updateBatchDepth > 0) {
+        return;
     }
 
-    repaint();
+    if (d->pendingFullUpdate) {
+        update();
+    } else if (!d->pendingUpdateRegion.isEmpty()) {
+        update(d->pendingUpdateRegion);
+    }
+
+    d->pendingFullUpdate = false;
+    d->pendingUpdateRegion = QRegion();
 }
 
 /*!
@@ -537,7 +951,7 @@ void DSimpleListView::selectAllItems()
         d->renderOffset = d->getTopRenderOffset();
 
         // Repaint.
-        repaint();
+        d->requestUpdate();
     }
 
 }
@@ -563,7 +977,7 @@ void DSimpleListView::selectFirstItem()
     d->renderOffset = d->getTopRenderOffset();
 
     // Repaint.
-    repaint();
+    d->requestUpdate();
 }
 
 /*!
@@ -587,7 +1001,7 @@ void DSimpleListView::selectLastItem()
     d->renderOffset = getBottomRenderOffset();
 
     // Repaint.
-    repaint();
+    d->requestUpdate();
 }
 
 /*!
@@ -645,14 +1059,14 @@ void DSimpleListView::shiftSelectToEnd()
         // Select items from last selected item to last item.
         else {
             // Found last selected index and do select operation.
-            int lastSelectionIndex = d->renderItems->indexOf(d->lastSelectItem);
+            int lastSelectionIndex = d->renderRowOf(d->lastSelectItem);
             shiftSelectItemsWithBound(lastSelectionIndex, d->renderItems->count() - 1);
 
             // Scroll to bottom.
             d->renderOffset = getBottomRenderOffset();
 
             // Repaint.
-            repaint();
+            d->requestUpdate();
         }
     }
 
@@ -673,14 +1087,14 @@ void DSimpleListView::shiftSelectToHome()
         // Select items from last selected item to first item.
         else {
             // Found last selected index and do select operation.
-            int lastSelectionIndex = d->renderItems->indexOf(d->lastSelectItem);
+            int lastSelectionIndex = d->renderRowOf(d->lastSelectItem);
             shiftSelectItemsWithBound(0, lastSelectionIndex);
 
             // Scroll to top.
             d->renderOffset = d->getTopRenderOffset();
 
             // Repaint.
-            repaint();
+            d->requestUpdate();
         }
     }
 
@@ -736,7 +1150,7 @@ void DSimpleListView::ctrlScrollPageUp()
 
     d->renderOffset = adjustRenderOffset(d->renderOffset - getScrollAreaHeight());
 
-    repaint();
+    d->requestUpdate();
 }
 
 void DSimpleListView::ctrlScrollPageDown()
@@ -745,7 +1159,7 @@ void DSimpleListView::ctrlScrollPageDown()
 
     d->renderOffset = adjustRenderOffset(d->renderOffset + getScrollAreaHeight());
 
-    repaint();
+    d->requestUpdate();
 }
 
 void DSimpleListView::ctrlScrollToHome()
@@ -754,7 +1168,7 @@ void DSimpleListView::ctrlScrollToHome()
 
     d->renderOffset = d->getTopRenderOffset();
 
-    repaint();
+    d->requestUpdate();
 }
 
 void DSimpleListView::ctrlScrollToEnd()
@@ -763,7 +1177,7 @@ void DSimpleListView::ctrlScrollToEnd()
 
     d->renderOffset = getBottomRenderOffset();
 
-    repaint();
+    d->requestUpdate();
 }
 
 void DSimpleListView::leaveEvent(QEvent * event)
@@ -787,11 +1201,25 @@ void DSimpleListView::hideScrollbar()
     d->mouseAtScrollArea = false;
     d->oldRenderOffset = d->renderOffset;
 
-    repaint();
+    d->requestUpdate();
 }
 
-bool DSimpleListView::eventFilter(QObject *, QEvent *)
+bool DSimpleListView::eventFilter(QObject *, QEvent *event)
 {
+    D_D(DSimpleListView);
+
+    switch (event->type()) {
+    case QEvent::FontChange:
+    case QEvent::PaletteChange:
+    case QEvent::StyleChange:
+    case QEvent::Resize:
+        // Cached foreground depends on font, palette and width of rows.
+        d->rowCache.clear();
+        break;
+    default:
+        break;
+    }
+
     return false;
 }
 
@@ -860,7 +1288,7 @@ void DSimpleListView::mouseMoveEvent(QMouseEvent *mouseEvent)
 #else
         d->renderOffset = adjustRenderOffset((mouseEvent->position().y() - barHeight / 2 - d->titleHeight) / (getScrollAreaHeight() * 1.0) * d->getItemsTotalHeight());
 #endif
-        repaint();
+        d->requestUpdate();
     }
     // Update scrollbar status with mouse position.
 #if QT_VERSION < QT_VERSION_CHECK(6,0,0)
@@ -870,7 +1298,7 @@ void DSimpleListView::mouseMoveEvent(QMouseEvent *mouseEvent)
     else if (isMouseAtScrollArea(mouseEvent->position().x()) != d->mouseAtScrollArea) {
         d->mouseAtScrollArea = isMouseAtScrollArea(mouseEvent->position().x());
 #endif
-        repaint();
+        d->requestUpdate();
     }
     // Otherwise to check titlebar arrow status.
     else {
@@ -912,13 +1340,13 @@ void DSimpleListView::mouseMoveEvent(QMouseEvent *mouseEvent)
             if (hoverColumn != d->titleHoverColumn) {
                 d->titleHoverColumn = hoverColumn;
 
-                repaint();
+                d->requestUpdate();
             }
         } else {
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-            int hoverItemIndex = (d->renderOffset + mouseEvent->y() - d->titleHeight) / d->rowHeight;
+            int hoverItemIndex = d->rowAt(mouseEvent->y());
 #else
-            int hoverItemIndex = (d->renderOffset + mouseEvent->position().y() - d->titleHeight) / d->rowHeight;
+            int hoverItemIndex = d->rowAt(mouseEvent->position().y());
 #endif
             // NOTE: hoverItemIndex may be less than 0, we need check index here.
             if (hoverItemIndex >= 0 && hoverItemIndex < (*d->renderItems).length()) {
@@ -948,7 +1376,7 @@ void DSimpleListView::mouseMoveEvent(QMouseEvent *mouseEvent)
                 if (d->drawHoverItem == NULL || !item->sameAs(d->drawHoverItem)) {
                     d->drawHoverItem = item;
 
-                    repaint();
+                    d->requestUpdate();
                 }
 
                 // Emit mouseHoverChanged signal.
@@ -1016,13 +1444,14 @@ void DSimpleListView::mousePressEvent(QMouseEvent *mouseEvent)
 
                             changeSortingStatus(d->defaultSortingColumn, d->defaultSortingOrder);
 
+                            d->sortedCount = 0;
                             d->sortItemsByColumn(columnCounter, (*d->sortingOrderes)[columnCounter]);
 
                             if (columnCounter != d->titlePressColumn) {
                                 d->titlePressColumn = columnCounter;
                             }
 
-                            repaint();
+                            d->requestUpdate();
                             break;
                         }
 
@@ -1052,7 +1481,7 @@ void DSimpleListView::mousePressEvent(QMouseEvent *mouseEvent)
 
                            changeColumnVisible(i, columnVisibles[i], columnVisibles);
 
-                           repaint();
+                           d_func()->requestUpdate();
                        });
 
                         menu->addAction(action);
@@ -1080,23 +1509,23 @@ void DSimpleListView::mousePressEvent(QMouseEvent *mouseEvent)
         // Scroll if click out of scrollbar area.
         else {
             d->renderOffset = adjustRenderOffset((my - barHeight / 2 - d->titleHeight) / (getScrollAreaHeight() * 1.0) * d->getItemsTotalHeight());
-            repaint();
+            d->requestUpdate();
         }
     }
     // Select items.
     else {
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-        int pressItemIndex = (d->renderOffset + mouseEvent->y() - d->titleHeight) / d->rowHeight;
+        int pressItemIndex = d->rowAt(mouseEvent->y());
 #else
-        int pressItemIndex = (d->renderOffset + mouseEvent->position().y() - d->titleHeight) / d->rowHeight;
+        int pressItemIndex = d->rowAt(mouseEvent->position().y());
 #endif
 
-        if (pressItemIndex >= d->renderItems->count()) {
+        if (pressItemIndex < 0 || pressItemIndex >= d->renderItems->count()) {
             if (!d->isKeepSelectWhenClickBlank) {
                 clearSelections();
             }
 
-            repaint();
+            d->requestUpdate();
         } else {
             if (mouseEvent->button() == Qt::LeftButton) {
                 if (pressItemIndex < d->renderItems->count()) {
@@ -1104,8 +1533,9 @@ void DSimpleListView::mousePressEvent(QMouseEvent *mouseEvent)
                     if (!d->isSingleSelect && mouseEvent->modifiers() == Qt::ControlModifier) {
                         DSimpleListItem *item = (*d->renderItems)[pressItemIndex];
 
-                        if (d->selectionItems->contains(item)) {
+                        if (d->selectionSet.contains(item)) {
                             d->selectionItems->removeOne(item);
+                            d->selectionSet.remove(item);
                         } else {
                             QList<DSimpleListItem*> items = QList<DSimpleListItem*>();
                             items << item;
@@ -1114,7 +1544,7 @@ void DSimpleListView::mousePressEvent(QMouseEvent *mouseEvent)
                     }
                     // Continuous selection of items when press shift modifier.
                     else if (!d->isSingleSelect && (mouseEvent->modifiers() == Qt::ShiftModifier) && !d->selectionItems->empty()) {
-                        int lastSelectionIndex = d->renderItems->indexOf(d->lastSelectItem);
+                        int lastSelectionIndex = d->renderRowOf(d->lastSelectItem);
                         int selectionStartIndex = std::min(pressItemIndex, lastSelectionIndex);
                         int selectionEndIndex = std::max(pressItemIndex, lastSelectionIndex);
 
@@ -1157,19 +1587,11 @@ void DSimpleListView::mousePressEvent(QMouseEvent *mouseEvent)
 #endif
                     mousePressChanged((*d->renderItems)[pressItemIndex], columnCounter, point);
 
-                    repaint();
+                    d->requestUpdate();
                 }
             } else if (mouseEvent->button() == Qt::RightButton) {
                 DSimpleListItem *pressItem = (*d->renderItems)[pressItemIndex];
-                bool pressInSelectionArea = false;
-
-                for (DSimpleListItem *item : *d->selectionItems) {
-                    if (item == pressItem) {
-                        pressInSelectionArea = true;
-
-                        break;
-                    }
-                }
+                bool pressInSelectionArea = d->selectionSet.contains(pressItem);
 
                 if (!pressInSelectionArea && pressItemIndex < d->renderItems->length()) {
                     clearSelections();
@@ -1178,7 +1600,7 @@ void DSimpleListView::mousePressEvent(QMouseEvent *mouseEvent)
                     items << (*d->renderItems)[pressItemIndex];
                     addSelections(items);
 
-                    repaint();
+                    d->requestUpdate();
                 }
 
                 if (d->selectionItems->length() > 0) {
@@ -1197,19 +1619,19 @@ void DSimpleListView::mouseReleaseEvent(QMouseEvent *mouseEvent)
         // Reset mouseDragScrollbar.
         d->mouseDragScrollbar = false;
 
-        repaint();
+        d->requestUpdate();
     } else {
         if (d->titlePressColumn != -1) {
             d->titlePressColumn = -1;
-            repaint();
+            d->requestUpdate();
         }
     }
 
     // Emit mouseReleaseChanged signal.
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-    int releaseItemIndex = (d->renderOffset + mouseEvent->y() - d->titleHeight) / d->rowHeight;
+    int releaseItemIndex = d->rowAt(mouseEvent->y());
 #else
-    int releaseItemIndex = (d->renderOffset + mouseEvent->position().y() - d->titleHeight) / d->rowHeight;
+    int releaseItemIndex = d->rowAt(mouseEvent->position().y());
 #endif
 
     if (releaseItemIndex >= 0 && releaseItemIndex < (*d->renderItems).length()) {
@@ -1253,13 +1675,13 @@ void DSimpleListView::wheelEvent(QWheelEvent *event)
         qreal scrollStep = delta.y() / 120.0;
         d->renderOffset = adjustRenderOffset(d->renderOffset - scrollStep * d->scrollUnit);
 
-        repaint();
+        d->requestUpdate();
     }
 
     event->accept();
 }
 
-void DSimpleListView::paintEvent(QPaintEvent *)
+void DSimpleListView::paintEvent(QPaintEvent *event)
 {
     D_D(DSimpleListView);
 
@@ -1287,7 +1709,6 @@ void DSimpleListView::paintEvent(QPaintEvent *)
     }
 
     int renderY = 0;
-    int renderHeight = 0;
     if (d->titleHeight > 0) {
         int columnCounter = 0;
         int columnRenderX = 0;
@@ -1340,7 +1761,6 @@ void DSimpleListView::paintEvent(QPaintEvent *)
         }
 
         renderY += d->titleHeight;
-        renderHeight += d->titleHeight;
     }
 
     // Draw background.
@@ -1353,52 +1773,42 @@ void DSimpleListView::paintEvent(QPaintEvent *)
     QPainterPath scrollAreaPath;
     scrollAreaPath.addRect(QRectF(rect().x(), rect().y() + d->titleHeight, rect().width(), getScrollAreaHeight()));
 
-    int rowCounter = 0;
-    for (DSimpleListItem *item:*d->renderItems) {
-        if (rowCounter >= d->renderOffset / d->rowHeight) {
-            // Clip item rect.
-            QPainterPath itemPath;
-            itemPath.addRect(QRect(0, renderY + rowCounter * d->rowHeight - d->renderOffset, rect().width(), d->rowHeight));
-            painter.setClipPath((framePath.intersected(scrollAreaPath)).intersected(itemPath));
-
-            // Draw item backround.
-            bool isSelect = d->selectionItems->contains(item);
-            bool isHover = d->drawHoverItem != NULL && item->sameAs(d->drawHoverItem);
+    const QPainterPath contentPath = framePath.intersected(scrollAreaPath);
+
+    // 只绘制与脏区域相交的可见行，行号直接由 renderOffset 和 rowHeight 计算得出
+    const QRect dirtyRect = event->rect().intersected(QRect(0, renderY, rect().width(), getScrollAreaHeight()));
+    const int firstRow = dirtyRect.isEmpty() ? 0 : std::max(0, d->rowAt(dirtyRect.top()));
+    const int lastRow = dirtyRect.isEmpty() ? -1 : std::min<int>(d->renderItems->count() - 1, d->rowAt(dirtyRect.bottom()));
+
+    for (int rowCounter = firstRow; rowCounter <= lastRow; ++rowCounter) {
+        DSimpleListItem *item = (*d->renderItems)[rowCounter];
+        const QRect itemRect(0, renderY + rowCounter * d->rowHeight - d->renderOffset, rect().width(), d->rowHeight);
+
+        // Clip item rect.
+        painter.setClipPath(contentPath);
+        painter.setClipRect(itemRect, Qt::IntersectClip);
+
+        // Draw item backround.
+        bool isSelect = d->selectionSet.contains(item);
+        bool isHover = d->drawHoverItem != NULL && item->sameAs(d->drawHoverItem);
+        painter.save();
+        item->drawBackground(itemRect,
+                             &painter,
+                             rowCounter,
+                             isSelect,
+                             isHover);
+        painter.restore();
+
+        // Draw item foreground, use cached pixmap if possible.
+        const QPixmap foreground = d->rowForeground(item, rowCounter, isSelect, isHover, renderWidths, painter);
+        if (!foreground.isNull()) {
             painter.save();
-            item->drawBackground(QRect(0, renderY + rowCounter * d->rowHeight - d->renderOffset, rect().width(), d->rowHeight),
-                                 &painter,
-                                 rowCounter,
-                                 isSelect,
-                                 isHover);
+            painter.setOpacity(1);
+            painter.drawPixmap(itemRect.topLeft(), foreground);
             painter.restore();
-
-            // Draw item foreground.
-            int columnCounter = 0;
-            int columnRenderX = 0;
-            for (int renderWidth:renderWidths) {
-                if (renderWidth > 0) {
-                    painter.save();
-                    item->drawForeground(QRect(columnRenderX, renderY + rowCounter * d->rowHeight - d->renderOffset, renderWidth, d->rowHeight),
-                                         &painter,
-                                         columnCounter,
-                                         rowCounter,
-                                         isSelect,
-                                         isHover);
-                    painter.restore();
-
-                    columnRenderX += renderWidth;
-                }
-                columnCounter++;
-            }
-
-            renderHeight += d->rowHeight;
-
-            if (renderHeight > rect().height()) {
-                break;
-            }
+        } else {
+            d->drawRowForeground(&painter, item, itemRect.y(), rowCounter, isSelect, isHover, renderWidths);
         }
-
-        rowCounter++;
     }
 
     // Keep clip area.
@@ -1496,7 +1906,7 @@ void DSimpleListView::selectNextItemWithOffset(int scrollOffset)
     } else {
         int lastIndex = 0;
         for (DSimpleListItem *item:*d->selectionItems) {
-            int index = d->renderItems->indexOf(item);
+            int index = d->renderRowOf(item);
             if (index > lastIndex) {
                 lastIndex = index;
             }
@@ -1518,7 +1928,7 @@ void DSimpleListView::selectNextItemWithOffset(int scrollOffset)
                 d->renderOffset = itemOffset;
             }
 
-            repaint();
+            d->requestUpdate();
         }
     }
 }
@@ -1535,7 +1945,7 @@ void DSimpleListView::selectPrevItemWithOffset(int scrollOffset)
     } else {
         int firstIndex = d->renderItems->count();
         for (DSimpleListItem *item:*d->selectionItems) {
-            int index = d->renderItems->indexOf(item);
+            int index = d->renderRowOf(item);
             if (index < firstIndex) {
                 firstIndex = index;
             }
@@ -1557,7 +1967,7 @@ void DSimpleListView::selectPrevItemWithOffset(int scrollOffset)
                 d->renderOffset = itemOffset;
             }
 
-            repaint();
+            d->requestUpdate();
         }
     }
 }
@@ -1569,15 +1979,11 @@ void DSimpleListView::shiftSelectItemsWithBound(int selectionStartIndex, int sel
     // Note: Shift operation always selection bound from last selection index to current index.
     // So we don't need *clear* lastSelectionIndex for keep shift + button is right logic.
     clearSelections(false);
-    QList<DSimpleListItem*> items = QList<DSimpleListItem*>();
-    int index = 0;
-    for (DSimpleListItem *item:*d->renderItems) {
-        if (index >= selectionStartIndex && index <= selectionEndIndex) {
-            items << item;
-        }
-
-        index++;
-    }
+    selectionStartIndex = std::max(0, selectionStartIndex);
+    selectionEndIndex = std::min<int>(d->renderItems->count() - 1, selectionEndIndex);
+    QList<DSimpleListItem*> items = selectionEndIndex >= selectionStartIndex
+            ? d->renderItems->mid(selectionStartIndex, selectionEndIndex - selectionStartIndex + 1)
+            : QList<DSimpleListItem*>();
 
     // Note: Shift operation always selection bound from last selection index to current index.
     // So we don't need *record* lastSelectionIndex for keep shift + button is right logic.
@@ -1597,7 +2003,7 @@ void DSimpleListView::shiftSelectPrevItemWithOffset(int scrollOffset)
         int firstIndex = d->renderItems->count();
         int lastIndex = 0;
         for (DSimpleListItem *item:*d->selectionItems) {
-            int index = d->renderItems->indexOf(item);
+            int index = d->renderRowOf(item);
 
             if (index < firstIndex) {
                 firstIndex = index;
@@ -1609,7 +2015,7 @@ void DSimpleListView::shiftSelectPrevItemWithOffset(int scrollOffset)
         }
 
         if (firstIndex != -1) {
-            int lastSelectionIndex = d->renderItems->indexOf(d->lastSelectItem);
+            int lastSelectionIndex = d->renderRowOf(d->lastSelectItem);
             int selectionStartIndex, selectionEndIndex;
 
             if (lastIndex == lastSelectionIndex) {
@@ -1626,7 +2032,7 @@ void DSimpleListView::shiftSelectPrevItemWithOffset(int scrollOffset)
                 d->renderOffset = adjustRenderOffset((selectionStartIndex - 1) * d->rowHeight + d->titleHeight);
             }
 
-            repaint();
+            d->requestUpdate();
         }
     }
 }
@@ -1644,7 +2050,7 @@ void DSimpleListView::shiftSelectNextItemWithOffset(int scrollOffset)
         int firstIndex = d->renderItems->count();
         int lastIndex = 0;
         for (DSimpleListItem *item:*d->selectionItems) {
-            int index = d->renderItems->indexOf(item);
+            int index = d->renderRowOf(item);
 
             if (index < firstIndex) {
                 firstIndex = index;
@@ -1656,7 +2062,7 @@ void DSimpleListView::shiftSelectNextItemWithOffset(int scrollOffset)
         }
 
         if (firstIndex != -1) {
-            int lastSelectionIndex = d->renderItems->indexOf(d->lastSelectItem);
+            int lastSelectionIndex = d->renderRowOf(d->lastSelectItem);
             int selectionStartIndex, selectionEndIndex;
 
             if (firstIndex == lastSelectionIndex) {
@@ -1674,7 +2080,7 @@ void DSimpleListView::shiftSelectNextItemWithOffset(int scrollOffset)
             }
 
 
-            repaint();
+            d->requestUpdate();
         }
     }
 }
@@ -1780,21 +2186,245 @@ int DSimpleListViewPrivate::getTopRenderOffset()
     return 0;
 }
 
+int DSimpleListViewPrivate::rowAt(int y) const
+{
+    if (rowHeight <= 0)
+        return -1;
+
+    const int contentY = renderOffset + y - titleHeight;
+
+    return contentY < 0 ? -1 : contentY / rowHeight;
+}
+
+QVector<DSimpleListViewPrivate::RowState> DSimpleListViewPrivate::visibleRowStates()
+{
+    D_Q(DSimpleListView);
+
+    QVector<RowState> rows;
+    const int firstRow = std::max(0, rowAt(titleHeight));
+    const int lastRow = std::min<int>(renderItems->count() - 1, rowAt(q->rect().height() - 1));
+
+    if (lastRow < firstRow)
+        return rows;
+
+    rows.reserve(lastRow - firstRow + 1);
+
+    for (int i = firstRow; i <= lastRow; ++i) {
+        DSimpleListItem *item = renderItems->at(i);
+        RowState state;
+        state.row = i;
+        state.key = item->identityKey();
+        state.version = item->contentVersion();
+        state.isSelect = selectionSet.contains(item);
+        state.isHover = drawHoverItem == item;
+        rows.append(state);
+    }
+
+    return rows;
+}
+
+int DSimpleListViewPrivate::renderRowOf(DSimpleListItem *item)
+{
+    if (renderRowsDirty) {
+        renderRows.clear();
+        renderRows.reserve(renderItems->count());
+
+        for (int i = 0; i < renderItems->count(); ++i)
+            renderRows.insert(renderItems->at(i), i);
+
+        renderRowsDirty = false;
+    }
+
+    return renderRows.value(item, -1);
+}
+
+void DSimpleListViewPrivate::requestUpdate()
+{
+    D_Q(DSimpleListView);
+
+    if (updateBatchDepth > 0) {
+        pendingFullUpdate = true;
+        return;
+    }
+
+    // update() 会把同一帧内的多次请求合并为一次绘制
+    q->update();
+}
+
+void DSimpleListViewPrivate::requestUpdate(const QRegion &region)
+{
+    D_Q(DSimpleListView);
+
+    if (updateBatchDepth > 0) {
+        pendingUpdateRegion += region;
+        return;
+    }
+
+    q->update(region);
+}
+
+void DSimpleListViewPrivate::drawRowForeground(QPainter *painter, DSimpleListItem *item, int y, int index, bool isSelect, bool isHover, const QList<int> &renderWidths)
+{
+    int columnCounter = 0;
+    int columnRenderX = 0;
+    for (int renderWidth:renderWidths) {
+        if (renderWidth > 0) {
+            painter->save();
+            item->drawForeground(QRect(columnRenderX, y, renderWidth, rowHeight),
+                                 painter,
+                                 columnCounter,
+                                 index,
+                                 isSelect,
+                                 isHover);
+            painter->restore();
+
+            columnRenderX += renderWidth;
+        }
+        columnCounter++;
+    }
+}
+
+QPixmap DSimpleListViewPrivate::rowForeground(DSimpleListItem *item, int index, bool isSelect, bool isHover, const QList<int> &renderWidths, const QPainter &viewPainter)
+{
+    D_Q(DSimpleListView);
+
+    if (!rowCacheEnabled || rowHeight <= 0) {
+        return QPixmap();
+    }
+
+    // 没有标识或内容版本的列表项无法判断缓存是否有效
+    const quint64 key = item->identityKey();
+    const quint64 version = key != 0 ? item->contentVersion() : 0;
+    if (version == 0) {
+        return QPixmap();
+    }
+
+    const qreal devicePixelRatio = q->devicePixelRatioF();
+    const qreal opacity = viewPainter.opacity();
+
+    if (RowCacheEntry *entry = rowCache.object(key)) {
+        if (entry->version == version && entry->index == index
+                && entry->isSelect == isSelect && entry->isHover == isHover
+                && qFuzzyCompare(entry->devicePixelRatio, devicePixelRatio)
+                && qFuzzyCompare(entry->opacity, opacity)
+                && entry->renderWidths == renderWidths) {
+            return entry->pixmap;
+        }
+    }
+
+    QPixmap pixmap(QSize(q->rect().width(), rowHeight) * devicePixelRatio);
+    pixmap.setDevicePixelRatio(devicePixelRatio);
+    pixmap.fill(Qt::transparent);
+
+    // 继承视图画笔的状态，保证与直接绘制的效果一致
+    QPainter painter(&pixmap);
+    painter.setRenderHints(viewPainter.renderHints());
+    painter.setFont(viewPainter.font());
+    painter.setPen(viewPainter.pen());
+    painter.setBrush(viewPainter.brush());
+    painter.setOpacity(opacity);
+    drawRowForeground(&painter, item, 0, index, isSelect, isHover, renderWidths);
+    painter.end();
+
+    RowCacheEntry *entry = new RowCacheEntry;
+    entry->version = version;
+    entry->renderWidths = renderWidths;
+    entry->devicePixelRatio = devicePixelRatio;
+    entry->opacity = opacity;
+    entry->index = index;
+    entry->isSelect = isSelect;
+    entry->isHover = isHover;
+    entry->pixmap = pixmap;
+
+    // 以 KB 为单位计算缓存开销
+    const int cost = std::max<qint64>(1, static_cast<qint64>(pixmap.width()) * pixmap.height() * pixmap.depth() / 8 / 1024);
+    rowCache.insert(key, entry, cost);
+
+    return pixmap;
+}
+
+void DSimpleListViewPrivate::markRenderItemsChanged()
+{
+    // 延迟到下次查找时再重建，连续多次修改只重建一次
+    renderRowsDirty = true;
+}
+
 QList<DSimpleListItem*> DSimpleListViewPrivate::getSearchItems(QList<DSimpleListItem*> items)
 {
     if (searchContent == "" || searchAlgorithm == NULL) {
         return items;
     } else {
-        QList<DSimpleListItem*> *searchItems = new QList<DSimpleListItem*>();
+        return filterSearchItems(items, searchAlgorithm, searchContent);
+    }
+}
 
-        for (DSimpleListItem *item : items) {
-            if (searchAlgorithm(item, searchContent)) {
-                searchItems->append(item);
-            }
-        }
+void DSimpleListViewPrivate::startSearch(const QList<DSimpleListItem*> &items, const QString &content)
+{
+    D_Q(DSimpleListView);
+
+    cancelSearch();
+
+    // 清理已经结束的搜索
+    searchFutures.erase(std::remove_if(searchFutures.begin(), searchFutures.end(), [](const QFuture<void> &future) {
+        return future.isFinished();
+    }), searchFutures.end());
+
+    const quint32 generation = searchGeneration;
+    const SearchAlgorithm algorithm = searchAlgorithm;
+    QSharedPointer<std::atomic_bool> canceled(new std::atomic_bool(false));
+
+    searchCanceled = canceled;
+    searchPending = true;
+    searchFutures << QtConcurrent::run(QThreadPool::globalInstance(), [this, q, items, content, algorithm, canceled, generation] {
+        const QList<DSimpleListItem*> searchItems = filterSearchItems(items, algorithm, content, canceled.data());
+
+        if (canceled->load())
+            return;
 
-        return *searchItems;
+        // 回到界面线程中一次性替换结果
+        QMetaObject::invokeMethod(q, [this, searchItems, content, generation] {
+            finishSearch(searchItems, content, generation);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void DSimpleListViewPrivate::finishSearch(const QList<DSimpleListItem*> &items, const QString &content, quint32 generation)
+{
+    D_Q(DSimpleListView);
+
+    if (generation != searchGeneration)
+        return;
+
+    searchPending = false;
+    *renderItems = items;
+    sortedCount = 0;
+    renderedSearchContent = content;
+    markRenderItemsChanged();
+    renderOffset = q->adjustRenderOffset(renderOffset);
+
+    requestUpdate();
+}
+
+void DSimpleListViewPrivate::cancelSearch()
+{
+    if (searchCanceled) {
+        searchCanceled->store(true);
+        searchCanceled.reset();
     }
+
+    // 丢弃已经投递到事件队列中的结果，被取消的搜索在下一次检查取消标记时自行结束
+    ++searchGeneration;
+    searchPending = false;
+}
+
+void DSimpleListViewPrivate::waitForSearch()
+{
+    cancelSearch();
+
+    // 后台线程会访问列表项，删除列表项之前必须等待其结束
+    for (QFuture<void> &future : searchFutures)
+        future.waitForFinished();
+    searchFutures.clear();
 }
 
 int DSimpleListView::getBottomRenderOffset()
@@ -1809,25 +2439,121 @@ int DSimpleListView::getBottomRenderOffset()
     }
 }
 
+bool DSimpleListViewPrivate::canSort() const
+{
+    return sortingAlgorithms->count() != 0 && sortingAlgorithms->count() == columnTitles.count() && sortingOrderes->count() == columnTitles.count();
+}
+
 void DSimpleListViewPrivate::sortItemsByColumn(int column, bool descendingSort)
 {
-    if (sortingAlgorithms->count() != 0 && sortingAlgorithms->count() == columnTitles.count() && sortingOrderes->count() == columnTitles.count()) {
-        std::sort(renderItems->begin(), renderItems->end(), [&](const DSimpleListItem *item1, const DSimpleListItem *item2) {
-                return (*sortingAlgorithms)[column](item1, item2, descendingSort);
-            });
+    if (!canSort()) {
+        return;
     }
+
+    const SortAlgorithm algorithm = sortingAlgorithms->at(column);
+    auto compare = [algorithm, descendingSort](const DSimpleListItem *item1, const DSimpleListItem *item2) {
+        return algorithm(item1, item2, descendingSort);
+    };
+
+    if (column != sortedColumn || descendingSort != sortedDescending) {
+        sortedCount = 0;
+    }
+
+    auto begin = renderItems->begin();
+    auto end = renderItems->end();
+    auto middle = begin + std::min<int>(sortedCount, renderItems->count());
+
+    // 已排序部分保持不变，只排序新增的列表项后再归并
+    if (parallelSort) {
+        parallelSortItems(middle, end, compare, stableSort);
+    } else {
+        sortItems(middle, end, compare, stableSort);
+    }
+    if (middle != begin && middle != end) {
+        std::inplace_merge(begin, middle, end, compare);
+    }
+
+    sortedColumn = column;
+    sortedDescending = descendingSort;
+    sortedCount = renderItems->count();
+    markRenderItemsChanged();
 }
 
-void DSimpleListView::startScrollbarHideTimer()
+void DSimpleListViewPrivate::restorePreviousOrder(const QHash<quint64, int> &previousRows, int previousCount)
 {
-    D_D(DSimpleListView);
+    // 按上次所在的行放回各自的位置，O(n) 完成；上次不存在的列表项依次放到末尾
+    QVector<DSimpleListItem*> previousSlots(previousCount, nullptr);
+    QList<DSimpleListItem*> appendedItems;
 
-    if (d->hideScrollbarTimer != NULL) {
-        d->hideScrollbarTimer->stop();
+    for (DSimpleListItem *item : *renderItems) {
+        const quint64 key = item->identityKey();
+        const auto row = key != 0 ? previousRows.constFind(key) : previousRows.constEnd();
+
+        if (row != previousRows.constEnd() && row.value() < previousCount && !previousSlots.at(row.value())) {
+            previousSlots[row.value()] = item;
+        } else {
+            appendedItems.append(item);
+        }
     }
 
-    d->hideScrollbarTimer = new QTimer();
-    connect(d->hideScrollbarTimer, SIGNAL(timeout()), this, SLOT(hideScrollbar()));
+    QList<DSimpleListItem*> items;
+    items.reserve(renderItems->count());
+    for (DSimpleListItem *item : previousSlots) {
+        if (item)
+            items.append(item);
+    }
+    items.append(appendedItems);
+
+    *renderItems = items;
+}
+
+void DSimpleListViewPrivate::takeSortedPrefix(int column, bool descendingSort)
+{
+    if (!canSort()) {
+        return;
+    }
+
+    const SortAlgorithm algorithm = sortingAlgorithms->at(column);
+    auto compare = [algorithm, descendingSort](const DSimpleListItem *item1, const DSimpleListItem *item2) {
+        return algorithm(item1, item2, descendingSort);
+    };
+
+    sortedColumn = column;
+    sortedDescending = descendingSort;
+
+    if (std::is_sorted_until(renderItems->begin(), renderItems->end(), compare) == renderItems->end()) {
+        sortedCount = renderItems->count();
+        return;
+    }
+
+    // 与前后相邻项顺序一致的列表项视为未变化，按原顺序留在前面作为已排序部分，
+    // 其余的列表项移到后面，由 sortItemsByColumn 排序后归并
+    QList<DSimpleListItem*> keptItems;
+    QList<DSimpleListItem*> movedItems;
+    keptItems.reserve(renderItems->count());
+
+    for (int i = 0; i < renderItems->count(); ++i) {
+        DSimpleListItem *item = renderItems->at(i);
+        const bool inPlace = (i == 0 || !compare(item, renderItems->at(i - 1)))
+                && (i + 1 == renderItems->count() || !compare(renderItems->at(i + 1), item))
+                && (keptItems.isEmpty() || !compare(item, keptItems.last()));
+
+        if (inPlace) {
+            keptItems.append(item);
+        } else {
+            movedItems.append(item);
+        }
+    }
+
+    sortedCount = keptItems.count();
+    keptItems.append(movedItems);
+    *renderItems = keptItems;
+}
+
+void DSimpleListView::startScrollbarHideTimer()
+{
+    D_D(DSimpleListView);
+
     d->hideScrollbarTimer->start(d->hideScrollbarDuration);
 }
 
@@ -21,6 +21,10 @@
 #include <QGuiApplication>
 #include <QAbstractItemView>
 #include <QPainterPath>
+#include <QElapsedTimer>
+#include <QMetaEnum>
+#include <QMutex>
+#include <QDebug>
 
 #include <qmath.h>
 #include <private/qfixed_p.h>
@@ -28,6 +32,7 @@
 #include <private/qicon_p.h>
 
 #include <math.h>
+#include <atomic>
 
 QT_BEGIN_NAMESPACE
 //extern Q_WIDGETS_EXPORT void qt_blurImage(QImage &blurImage, qreal radius, bool quality, int transposed = 0);
@@ -222,6 +227,183 @@ bool DStyle::isMenuKeyboardSearchDisabled()
     });
 }
 
+namespace {
+enum PaintProfileKind {
+    ProfilePrimitive,
+    ProfileControl,
+    ProfileComplexControl
+};
+
+struct PaintProfileEntry
+{
+    quint64 calls = 0;
+    qint64 nsecs = 0;
+};
+
+struct PaintProfileData
+{
+    QMutex mutex;
+    QHash<QPair<int, int>, PaintProfileEntry> elements;
+    QHash<QByteArray, PaintProfileEntry> widgets;
+};
+}
+
+Q_GLOBAL_STATIC(PaintProfileData, _d_paintProfile)
+static std::atomic<bool> _d_paintProfileEnabled(qEnvironmentVariableIsSet("D_DTK_STYLE_PROFILE"));
+
+static void dumpPaintProfileAtExit()
+{
+    DStyle::dumpPaintProfile();
+}
+
+static void recordPaintProfile(PaintProfileKind kind, int element, const QWidget *w, qint64 nsecs)
+{
+    static std::atomic<bool> postRoutineAdded(false);
+    if (!postRoutineAdded.exchange(true) && qEnvironmentVariableIsSet("D_DTK_STYLE_PROFILE"))
+        qAddPostRoutine(dumpPaintProfileAtExit);
+
+    PaintProfileData *data = _d_paintProfile;
+    QMutexLocker locker(&data->mutex);
+
+    PaintProfileEntry &entry = data->elements[qMakePair(int(kind), element)];
+    ++entry.calls;
+    entry.nsecs += nsecs;
+
+    PaintProfileEntry &widgetEntry = data->widgets[w ? QByteArray(w->metaObject()->className()) : QByteArrayLiteral("(none)")];
+    ++widgetEntry.calls;
+    widgetEntry.nsecs += nsecs;
+}
+
+// 关闭时只有一次分支判断，开启后计入包含嵌套调用在内的耗时
+template<typename Fun>
+static inline void profilePaint(PaintProfileKind kind, int element, const QWidget *w, Fun fun)
+{
+    if (Q_LIKELY(!_d_paintProfileEnabled.load(std::memory_order_relaxed)))
+        return fun();
+
+    QElapsedTimer timer;
+    timer.start();
+    fun();
+    recordPaintProfile(kind, element, w, timer.nsecsElapsed());
+}
+
+static QByteArray paintProfileElementName(PaintProfileKind kind, int element)
+{
+    const char *key = nullptr;
+    const char *prefix = nullptr;
+
+    switch (kind) {
+    case ProfilePrimitive:
+        prefix = "PE";
+        key = element < QStyle::PE_CustomBase ? QMetaEnum::fromType<QStyle::PrimitiveElement>().valueToKey(element)
+                                              : QMetaEnum::fromType<DStyle::PrimitiveElement>().valueToKey(element);
+        break;
+    case ProfileControl:
+        prefix = "CE";
+        key = element < QStyle::CE_CustomBase ? QMetaEnum::fromType<QStyle::ControlElement>().valueToKey(element)
+                                              : QMetaEnum::fromType<DStyle::ControlElement>().valueToKey(element);
+        break;
+    case ProfileComplexControl:
+        prefix = "CC";
+        key = QMetaEnum::fromType<QStyle::ComplexControl>().valueToKey(element);
+        break;
+    }
+
+    if (key)
+        return QByteArray(key);
+
+    return QByteArray(prefix) + "_0x" + QByteArray::number(element, 16);
+}
+
+static QString paintProfileLine(const QByteArray &name, const PaintProfileEntry &entry)
+{
+    return QStringLiteral("  %1 calls: %2 total: %3 ms avg: %4 us\n")
+            .arg(QString::fromLatin1(name), -40)
+            .arg(entry.calls, 10)
+            .arg(entry.nsecs / 1e6, 10, 'f', 3)
+            .arg(entry.calls ? entry.nsecs / 1e3 / entry.calls : 0, 10, 'f', 2);
+}
+
+/*!
+  \brief 设置是否统计绘制耗时.
+
+  开启后，DStyle 会按元素（包括 QStyle 和 DStyle 扩展的 PrimitiveElement 、
+  ControlElement 以及 ComplexControl）和控件类型记录 drawPrimitive 、 drawControl
+  及 drawComplexControl 的调用次数和累计耗时（包含嵌套调用）。也可以通过设置环境变量
+  D_DTK_STYLE_PROFILE 开启，此时程序退出时会自动输出统计结果。
+
+  \note 子类完全重写绘制函数且未调用 DStyle 的实现时，对应的元素不会被统计。
+  \sa paintProfileReport() resetPaintProfile()
+ */
+void DStyle::setPaintProfileEnabled(bool enabled)
+{
+    _d_paintProfileEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+/*!
+  \brief 返回是否正在统计绘制耗时.
+  \sa setPaintProfileEnabled()
+ */
+bool DStyle::paintProfileEnabled()
+{
+    return _d_paintProfileEnabled.load(std::memory_order_relaxed);
+}
+
+/*!
+  \brief 返回绘制耗时的统计结果，按累计耗时从高到低排列.
+  \sa dumpPaintProfile()
+ */
+QString DStyle::paintProfileReport()
+{
+    PaintProfileData *data = _d_paintProfile;
+    QMutexLocker locker(&data->mutex);
+
+    auto byTime = [](const QPair<QByteArray, PaintProfileEntry> &a, const QPair<QByteArray, PaintProfileEntry> &b) {
+        return a.second.nsecs > b.second.nsecs;
+    };
+
+    QList<QPair<QByteArray, PaintProfileEntry>> elements;
+    for (auto it = data->elements.cbegin(); it != data->elements.cend(); ++it)
+        elements.append(qMakePair(paintProfileElementName(PaintProfileKind(it.key().first), it.key().second), it.value()));
+    std::sort(elements.begin(), elements.end(), byTime);
+
+    QList<QPair<QByteArray, PaintProfileEntry>> widgets;
+    for (auto it = data->widgets.cbegin(); it != data->widgets.cend(); ++it)
+        widgets.append(qMakePair(it.key(), it.value()));
+    std::sort(widgets.begin(), widgets.end(), byTime);
+
+    QString report = QStringLiteral("DStyle paint profile by element:\n");
+    for (const auto &item : qAsConst(elements))
+        report += paintProfileLine(item.first, item.second);
+
+    report += QStringLiteral("DStyle paint profile by widget:\n");
+    for (const auto &item : qAsConst(widgets))
+        report += paintProfileLine(item.first, item.second);
+
+    return report;
+}
+
+/*!
+  \brief 将 paintProfileReport() 的内容输出到日志.
+ */
+void DStyle::dumpPaintProfile()
+{
+    const QString &report = paintProfileReport();
+    for (const QString &line : report.split(QLatin1Char('\n'), Qt::SkipEmptyParts))
+        qInfo().noquote() << line;
+}
+
+/*!
+  \brief 清空已记录的绘制耗时统计.
+ */
+void DStyle::resetPaintProfile()
+{
+    PaintProfileData *data = _d_paintProfile;
+    QMutexLocker locker(&data->mutex);
+    data->elements.clear();
+    data->widgets.clear();
+}
+
 namespace DDrawUtils {
 static QImage dropShadow(const QPixmap &px, qreal radius, const QColor &color)
 {
@@ -2143,39 +2325,41 @@ static DStyle::StateFlags getFlags(const QStyleOption *option)
  */
 void DStyle::drawPrimitive(QStyle::PrimitiveElement pe, const QStyleOption *opt, QPainter *p, const QWidget *w) const
 {
-    switch (pe) {
-    case PE_IndicatorArrowUp:
-        p->setPen(QPen(opt->palette.windowText(), 1));
-        return DDrawUtils::drawArrowUp(p, opt->rect);
-    case PE_IndicatorArrowDown:
-        p->setPen(QPen(opt->palette.windowText(), 1));
-        return DDrawUtils::drawArrowDown(p, opt->rect);
-    case PE_IndicatorArrowRight:
-        p->setPen(QPen(opt->palette.windowText(), 1));
-        return DDrawUtils::drawArrowRight(p, opt->rect);
-    case PE_IndicatorArrowLeft:
-        p->setPen(QPen(opt->palette.windowText(), 1));
-        return DDrawUtils::drawArrowLeft(p, opt->rect);
-    case PE_IndicatorHeaderArrow:
-        if (const QStyleOptionHeader *header = qstyleoption_cast<const QStyleOptionHeader *>(opt)) {
+    profilePaint(ProfilePrimitive, pe, w, [&] {
+        switch (pe) {
+        case PE_IndicatorArrowUp:
+            p->setPen(QPen(opt->palette.windowText(), 1));
+            return DDrawUtils::drawArrowUp(p, opt->rect);
+        case PE_IndicatorArrowDown:
             p->setPen(QPen(opt->palette.windowText(), 1));
-            // sort up draw down icon, since both windows, mac and even wikipedia did this...
-            if (header->sortIndicator & QStyleOptionHeader::SortUp) {
-                return proxy()->drawPrimitive(PE_IndicatorArrowDown, opt, p, w);
-            } else if (header->sortIndicator & QStyleOptionHeader::SortDown) {
-                return proxy()->drawPrimitive(PE_IndicatorArrowUp, opt, p, w);
+            return DDrawUtils::drawArrowDown(p, opt->rect);
+        case PE_IndicatorArrowRight:
+            p->setPen(QPen(opt->palette.windowText(), 1));
+            return DDrawUtils::drawArrowRight(p, opt->rect);
+        case PE_IndicatorArrowLeft:
+            p->setPen(QPen(opt->palette.windowText(), 1));
+            return DDrawUtils::drawArrowLeft(p, opt->rect);
+        case PE_IndicatorHeaderArrow:
+            if (const QStyleOptionHeader *header = qstyleoption_cast<const QStyleOptionHeader *>(opt)) {
+                p->setPen(QPen(opt->palette.windowText(), 1));
+                // sort up draw down icon, since both windows, mac and even wikipedia did this...
+                if (header->sortIndicator & QStyleOptionHeader::SortUp) {
+                    return proxy()->drawPrimitive(PE_IndicatorArrowDown, opt, p, w);
+                } else if (header->sortIndicator & QStyleOptionHeader::SortDown) {
+                    return proxy()->drawPrimitive(PE_IndicatorArrowUp, opt, p, w);
+                }
             }
+            return;
+        default:
+            break;
         }
-        return;
-    default:
-        break;
-    }
 
-    if (Q_UNLIKELY(pe < QStyle::PE_CustomBase)) {
-        return QCommonStyle::drawPrimitive(pe, opt, p, w);
-    }
+        if (Q_UNLIKELY(pe < QStyle::PE_CustomBase)) {
+            return QCommonStyle::drawPrimitive(pe, opt, p, w);
+        }
 
-    drawPrimitive(this, static_cast<PrimitiveElement>(pe), opt, p, w);
+        drawPrimitive(this, static_cast<PrimitiveElement>(pe), opt, p, w);
+    });
 }
 
 /*!
@@ -2184,11 +2368,24 @@ void DStyle::drawPrimitive(QStyle::PrimitiveElement pe, const QStyleOption *opt,
  */
 void DStyle::drawControl(QStyle::ControlElement ce, const QStyleOption *opt, QPainter *p, const QWidget *w) const
 {
-    if (Q_UNLIKELY(ce < QStyle::CE_CustomBase)) {
-        return QCommonStyle::drawControl(ce, opt, p, w);
-    }
+    profilePaint(ProfileControl, ce, w, [&] {
+        if (Q_UNLIKELY(ce < QStyle::CE_CustomBase)) {
+            return QCommonStyle::drawControl(ce, opt, p, w);
+        }
 
-    drawControl(this, static_cast<ControlElement>(ce), opt, p, w);
+        drawControl(this, static_cast<ControlElement>(ce), opt, p, w);
+    });
+}
+
+/*!
+  \brief DStyle::drawComplexControl
+  \sa QStyle::drawComplexControl()
+ */
+void DStyle::drawComplexControl(QStyle::ComplexControl cc, const QStyleOptionComplex *opt, QPainter *p, const QWidget *w) const
+{
+    profilePaint(ProfileComplexControl, cc, w, [&] {
+        QCommonStyle::drawComplexControl(cc, opt, p, w);
+    });
 }
 
 /*!
@@ -21,6 +21,7 @@
 #include <QTableView>
 #include <QListWidget>
 #include <QPointer>
+#include <QCache>
 #include <private/qlayoutengine_p.h>
 #include <DGuiApplicationHelper>
 #include <DDciIcon>
@@ -29,6 +30,9 @@ Q_DECLARE_METATYPE(QMargins)
 
 DWIDGET_BEGIN_NAMESPACE
 
+// 最多缓存该数量的列表项的 action 布局，超过后淘汰最久未绘制的项
+static const int ActionLayoutCacheSize = 1024;
+
 struct ActionListData : public QSharedData {
     explicit ActionListData() { }
     explicit ActionListData(const DViewItemActionList& v)
@@ -106,15 +110,19 @@ static void registerMetaType ()
     #endif
 }
 
-static DViewItemActionList qvariantToActionList(const QVariant &v)
+static DViewItemActionList actionListOf(const ActionList &wrapper)
 {
-    const ActionList &wrapper = v.value<ActionList>();
     if (wrapper.isValid())
         return wrapper.constData()->list;
 
     return DViewItemActionList();
 }
 
+static DViewItemActionList qvariantToActionList(const QVariant &v)
+{
+    return actionListOf(v.value<ActionList>());
+}
+
 static QVariant actionListToQVariant(const DViewItemActionList &v)
 {
     ActionList wrapper(new ActionListData(v));
@@ -130,6 +138,20 @@ public:
 
     }
 
+    // 任何影响布局的属性变化都会分配一个新的递增的版本号，
+    // 用于判断缓存的 action 布局是否仍然有效
+    void touch()
+    {
+        static QAtomicInt revisionCounter;
+        revision = revisionCounter.fetchAndAddRelaxed(1) + 1;
+        fontDirty = true;
+    }
+
+    static int revisionOf(const DViewItemAction *action)
+    {
+        return action->d_func()->revision;
+    }
+
     Qt::Alignment alignment;
     QSize iconSize;
     QSize maxSize;
@@ -141,6 +163,11 @@ public:
     qint8 colorType = -1;
     qint8 colorRole = -1;
     qint8 fontSize = -1;
+
+    int revision = 0;
+    mutable bool fontDirty = true;
+    mutable quint16 cachedFontPixelSize = 0;
+    mutable QFont cachedFont;
 };
 
 class DStyledItemDelegatePrivate : public DCORE_NAMESPACE::DObjectPrivate
@@ -198,7 +225,7 @@ public:
     }
 
     // get rect in AlignVCenter layout for text.
-    static QRect textAndTextActionsLayout(const QRect &textRect, const QStyle *style, const QStyleOptionViewItem &option, const QModelIndex &index)
+    static QRect textAndTextActionsLayout(const QRect &textRect, const QStyle *style, const QStyleOptionViewItem &option, const DViewItemActionList &textActions)
     {
         QStyleOptionViewItem opt = option;
         opt.displayAlignment |= Qt::AlignVCenter;
@@ -207,7 +234,7 @@ public:
         if (!opt.text.isEmpty())
             size = DStyle::viewItemSize(style, &opt, Qt::DisplayRole);
 
-        for (const DViewItemAction *action : qvariantToActionList(index.data(Dtk::TextActionListRole))) {
+        for (const DViewItemAction *action : textActions) {
             const QSize &action_size = displayActionSize(action, style, opt);
             size.setWidth(qMax(size.width(), action_size.width()));
             size.setHeight(size.height() + action_size.height());
@@ -409,25 +436,61 @@ public:
         }
     }
 
-    static QSize drawActions(QPainter *pa, const QStyleOptionViewItem &option, const QVariant &value, Qt::Edge edge, QList<QPair<QAction*, QRect>> *clickableActionRect)
+    struct ActionsLayout
+    {
+        // 持有 action 列表的引用，保证缓存期间列表不会被释放
+        ActionList list;
+        DViewItemActionList visibleActions;
+        QList<QRect> rects;
+        QSize bounding;
+    };
+
+    struct ItemActionLayout
+    {
+        QRect rect;
+        Qt::LayoutDirection direction = Qt::LeftToRight;
+        QSize decorationSize;
+        int spacing = 0;
+        int revision = -1;
+        uint widgetSizeSeed = 0;
+        ActionsLayout edges[4];
+        ActionList textActions;
+    };
+
+    static constexpr Qt::Edge actionEdges[4] = { Qt::LeftEdge, Qt::RightEdge, Qt::TopEdge, Qt::BottomEdge };
+    static constexpr Dtk::ItemDataRole actionRoles[4] = { Dtk::LeftActionListRole, Dtk::RightActionListRole,
+                                                          Dtk::TopActionListRole, Dtk::BottomActionListRole };
+
+    static void updateActionsState(const ActionList &list, const QStyleOptionViewItem &option)
     {
-        const DViewItemActionList &actionList = qvariantToActionList(value);
-        DViewItemActionList visiable_actionList;
-        for (auto action : actionList) {
-            if (action->isVisible())
-                visiable_actionList.append(action);
+        if (!list.isValid())
+            return;
+
+        for (auto action : list.constData()->list) {
             action->setEnabled(option.state & QStyle::State_Enabled);
             if (QWidget *actionWidget = action->widget()) {
                 actionWidget->setVisible(action->isVisible());
                 actionWidget->setEnabled(option.state & QStyle::State_Enabled);
             }
         }
+    }
+
+    static void layoutActions(const QStyleOptionViewItem &option, Qt::Edge edge, ActionsLayout *layout)
+    {
+        layout->visibleActions.clear();
+        layout->rects.clear();
+
+        if (layout->list.isValid()) {
+            for (auto action : layout->list.constData()->list) {
+                if (action->isVisible())
+                    layout->visibleActions.append(action);
+            }
+        }
 
         const Qt::Orientation orientation = (edge == Qt::TopEdge || edge == Qt::BottomEdge) ? Qt::Vertical : Qt::Horizontal;
         QSize bounding;
-        const QList<QRect> &list = doActionsLayout(option.rect, visiable_actionList, orientation, option.direction, option.decorationSize, &bounding);
+        const QList<QRect> &list = doActionsLayout(option.rect, layout->visibleActions, orientation, option.direction, option.decorationSize, &bounding);
         QPoint origin(0, 0);
-        int spacing = DStyleHelper(qApp->style()).pixelMetric(DStyle::PM_ContentsSpacing);
 
         switch (edge) {
         case Qt::BottomEdge:
@@ -440,9 +503,17 @@ public:
             break;
         }
 
-        for (int i = 0; i < list.count(); ++i) {
-            DViewItemAction *action = visiable_actionList.at(i);
-            const QRect &rect = list.at(i).translated(origin);
+        layout->rects.reserve(list.size());
+        for (const QRect &rect : list)
+            layout->rects.append(rect.translated(origin));
+        layout->bounding = bounding;
+    }
+
+    static QSize drawActions(QPainter *pa, const QStyleOptionViewItem &option, const ActionsLayout &layout, int spacing, QList<QPair<QAction*, QRect>> *clickableActionRect)
+    {
+        for (int i = 0; i < layout.rects.count(); ++i) {
+            DViewItemAction *action = layout.visibleActions.at(i);
+            const QRect &rect = layout.rects.at(i);
 
             drawAction(pa, option, rect, action, spacing);
 
@@ -451,26 +522,69 @@ public:
             }
         }
 
-        return bounding;
+        return layout.bounding;
     }
 
-    static DViewItemActionList allActions(const QModelIndex &index)
+    static void actionsRevision(const ActionList &list, int *revision, uint *widgetSizeSeed)
     {
-        static const QVector<ItemDataRole> rules {
-            LeftActionListRole,
-                    TopActionListRole,
-                    RightActionListRole,
-                    BottomActionListRole,
-                    TextActionListRole
-        };
-        DViewItemActionList results;
-        for (const auto role: rules) {
-            const auto &list = qvariantToActionList(index.data(role));
-            if (list.isEmpty())
-                continue;
-            results << list;
+        if (!list.isValid())
+            return;
+
+        for (const DViewItemAction *action : list.constData()->list) {
+            *revision = qMax(*revision, DViewItemActionPrivate::revisionOf(action));
+            // 控件的大小变化不会通知 action，需要单独比较
+            if (const QWidget *actionWidget = action->widget())
+                *widgetSizeSeed = *widgetSizeSeed * 31 + uint(actionWidget->width()) * 17 + uint(actionWidget->height());
         }
-        return results;
+    }
+
+    static void actionsRevision(const ItemActionLayout &layout, int *revision, uint *widgetSizeSeed)
+    {
+        *revision = 0;
+        *widgetSizeSeed = 0;
+
+        for (const ActionsLayout &edge : layout.edges)
+            actionsRevision(edge.list, revision, widgetSizeSeed);
+    }
+
+    // 同一项只在区域或 action 变化时重新布局，悬停等状态变化引起的重绘直接使用缓存的结果
+    const ItemActionLayout &itemActionLayout(const QStyleOptionViewItem &option, const QModelIndex &index)
+    {
+        bindItemCacheModel(index.model());
+
+        ItemActionLayout *cached = actionLayoutCache.object(index);
+        if (!cached) {
+            cached = new ItemActionLayout;
+            for (int i = 0; i < 4; ++i)
+                cached->edges[i].list = index.data(actionRoles[i]).value<ActionList>();
+            cached->textActions = index.data(Dtk::TextActionListRole).value<ActionList>();
+            actionLayoutCache.insert(index, cached);
+        }
+
+        ItemActionLayout &layout = *cached;
+        for (const ActionsLayout &edge : layout.edges)
+            updateActionsState(edge.list, option);
+
+        int revision = 0;
+        uint widgetSizeSeed = 0;
+        actionsRevision(layout, &revision, &widgetSizeSeed);
+
+        if (layout.revision == revision && layout.widgetSizeSeed == widgetSizeSeed && layout.rect == option.rect
+                && layout.direction == option.direction && layout.decorationSize == option.decorationSize) {
+            return layout;
+        }
+
+        layout.rect = option.rect;
+        layout.direction = option.direction;
+        layout.decorationSize = option.decorationSize;
+        layout.revision = revision;
+        layout.widgetSizeSeed = widgetSizeSeed;
+        layout.spacing = DStyleHelper(qApp->style()).pixelMetric(DStyle::PM_ContentsSpacing);
+
+        for (int i = 0; i < 4; ++i)
+            layoutActions(option, actionEdges[i], &layout.edges[i]);
+
+        return layout;
     }
 
     bool readyRecordVisibleWidgetOfCurrentFrame()
@@ -502,25 +616,293 @@ public:
         currentWidgets.clear();
     }
 
-    void recordVisibleWidgetOfCurrentFrame(const QModelIndex &index)
+    void recordVisibleWidgetOfCurrentFrame(const ItemActionLayout &layout)
     {
         // only record virsual widget when starting record.
         if (Q_UNLIKELY(!hasStartRecord))
             return;
 
-        for (auto action : allActions(index)) {
-            if (!action->isVisible())
+        auto record = [this](const ActionList &list) {
+            if (!list.isValid())
+                return;
+
+            for (auto action : list.constData()->list) {
+                if (!action->isVisible())
+                    continue;
+
+                if (auto widget = action->widget())
+                    currentWidgets.append(QPointer<QWidget>(widget));
+            }
+        };
+
+        for (const ActionsLayout &edge : layout.edges)
+            record(edge.list);
+        record(layout.textActions);
+    }
+
+    struct SizeHintEntry
+    {
+        QSize size;
+        // 计算大小时使用的 action 列表及其版本，action 的文本、字体等变化不会触发 dataChanged
+        ActionList actions[5];
+        int revision = -1;
+        uint widgetSizeSeed = 0;
+
+        bool isValid() const
+        {
+            int currentRevision = 0;
+            uint currentWidgetSizeSeed = 0;
+            for (const ActionList &list : actions)
+                actionsRevision(list, &currentRevision, &currentWidgetSizeSeed);
+
+            return size.isValid() && revision == currentRevision && widgetSizeSeed == currentWidgetSizeSeed;
+        }
+    };
+
+    struct SizeHintOptionKey
+    {
+        const QWidget *widget = nullptr;
+        QFont font;
+        QSize decorationSize;
+        int decorationPosition = -1;
+        int displayAlignment = 0;
+        int features = 0;
+        int direction = 0;
+        int rectWidth = -1;
+
+        inline bool operator==(const SizeHintOptionKey &other) const
+        {
+            return widget == other.widget && decorationSize == other.decorationSize
+                    && decorationPosition == other.decorationPosition && displayAlignment == other.displayAlignment
+                    && features == other.features && direction == other.direction
+                    && rectWidth == other.rectWidth && font == other.font;
+        }
+    };
+
+    static SizeHintOptionKey sizeHintOptionKey(const QStyleOptionViewItem &option)
+    {
+        SizeHintOptionKey key;
+        key.widget = option.widget;
+        key.font = option.font;
+        key.decorationSize = option.decorationSize;
+        key.decorationPosition = option.decorationPosition;
+        key.displayAlignment = option.displayAlignment;
+        key.features = option.features;
+        key.direction = option.direction;
+        // 只有自动换行时宽度才会影响 sizeHint
+        if (option.features & QStyleOptionViewItem::WrapText)
+            key.rectWidth = option.rect.width();
+
+        return key;
+    }
+
+    static bool hasUniformItemSizes(const QStyleOptionViewItem &option, const QModelIndex &index)
+    {
+        if (const QListView *lv = qobject_cast<const QListView *>(option.widget)) {
+            if (lv->uniformItemSizes())
+                return true;
+        }
+
+        return index.model()->property("_d_dtk_uniformItemSizes").toBool();
+    }
+
+    // 只影响颜色、提示等绘制内容的角色变化时不需要重新计算大小
+    static bool rolesAffectSize(const QVector<int> &roles)
+    {
+        if (roles.isEmpty())
+            return true;
+
+        for (int role : roles) {
+            switch (role) {
+            case Qt::ToolTipRole:
+            case Qt::StatusTipRole:
+            case Qt::WhatsThisRole:
+            case Qt::BackgroundRole:
+            case Qt::ForegroundRole:
+            case Dtk::ViewItemBackgroundRole:
+            case Dtk::ViewItemForegroundRole:
+            case Dtk::ViewItemShowToolTipRole:
                 continue;
+            default:
+                return true;
+            }
+        }
 
-            if (auto widget = action->widget())
-                currentWidgets.append(QPointer<QWidget>(widget));
+        return false;
+    }
+
+    void bindItemCacheModel(const QAbstractItemModel *model)
+    {
+        if (cacheModel == model)
+            return;
+
+        for (const auto &connection : qAsConst(cacheModelConnections))
+            QObject::disconnect(connection);
+        cacheModelConnections.clear();
+        clearItemCache();
+        cacheModel = model;
+
+        if (!model)
+            return;
+
+        D_Q(DStyledItemDelegate);
+        auto clear = [this] { clearItemCache(); };
+        auto endMove = [this] { endMoveItemCache(); };
+        cacheModelConnections << QObject::connect(model, &QAbstractItemModel::dataChanged, q,
+                                                  [this](const QModelIndex &topLeft, const QModelIndex &bottomRight, const QVector<int> &roles) {
+            if (rolesAffectSize(roles))
+                invalidateItemCache(topLeft, bottomRight);
+        });
+        // 行的增删和移动只影响其后的行，排序等布局变化时缓存项跟随各自的列表项
+        cacheModelConnections << QObject::connect(model, &QAbstractItemModel::rowsAboutToBeInserted, q,
+                                                  [this](const QModelIndex &parent, int first) {
+            beginMoveItemCache(parent, first);
+        });
+        cacheModelConnections << QObject::connect(model, &QAbstractItemModel::rowsInserted, q, endMove);
+        cacheModelConnections << QObject::connect(model, &QAbstractItemModel::rowsAboutToBeRemoved, q,
+                                                  [this](const QModelIndex &parent, int first) {
+            beginMoveItemCache(parent, first);
+        });
+        cacheModelConnections << QObject::connect(model, &QAbstractItemModel::rowsRemoved, q, endMove);
+        cacheModelConnections << QObject::connect(model, &QAbstractItemModel::rowsAboutToBeMoved, q,
+                                                  [this](const QModelIndex &sourceParent, int sourceStart, int,
+                                                         const QModelIndex &destinationParent, int destinationRow) {
+            if (sourceParent == destinationParent) {
+                beginMoveItemCache(sourceParent, qMin(sourceStart, destinationRow));
+            } else {
+                beginMoveItemCache(QModelIndex(), -1);
+            }
+        });
+        cacheModelConnections << QObject::connect(model, &QAbstractItemModel::rowsMoved, q, endMove);
+        cacheModelConnections << QObject::connect(model, &QAbstractItemModel::layoutAboutToBeChanged, q, [this] {
+            beginMoveItemCache(QModelIndex(), -1);
+        });
+        cacheModelConnections << QObject::connect(model, &QAbstractItemModel::layoutChanged, q, endMove);
+        cacheModelConnections << QObject::connect(model, &QAbstractItemModel::columnsInserted, q, clear);
+        cacheModelConnections << QObject::connect(model, &QAbstractItemModel::columnsAboutToBeRemoved, q, clear);
+        cacheModelConnections << QObject::connect(model, &QAbstractItemModel::columnsMoved, q, clear);
+        cacheModelConnections << QObject::connect(model, &QAbstractItemModel::modelReset, q, clear);
+        cacheModelConnections << QObject::connect(model, &QObject::destroyed, q, [this] {
+            cacheModelConnections.clear();
+            cacheModel = nullptr;
+            clearItemCache();
+        });
+    }
+
+    void invalidateItemCache(const QModelIndex &topLeft, const QModelIndex &bottomRight)
+    {
+        uniformSizeHint = SizeHintEntry();
+
+        if (!topLeft.isValid() || !bottomRight.isValid()) {
+            clearItemCache();
+            return;
+        }
+
+        const QModelIndex &parent = topLeft.parent();
+        const qint64 count = qint64(bottomRight.row() - topLeft.row() + 1) * (bottomRight.column() - topLeft.column() + 1);
+
+        invalidateItemCache(&sizeHintCache, topLeft, bottomRight, parent, count);
+        invalidateItemCache(&actionLayoutCache, topLeft, bottomRight, parent, count);
+    }
+
+    static bool isInRange(const QModelIndex &key, const QModelIndex &topLeft, const QModelIndex &bottomRight, const QModelIndex &parent)
+    {
+        return key.row() >= topLeft.row() && key.row() <= bottomRight.row()
+                && key.column() >= topLeft.column() && key.column() <= bottomRight.column()
+                && key.parent() == parent;
+    }
+
+    template<typename Cache>
+    void invalidateItemCache(Cache *cache, const QModelIndex &topLeft, const QModelIndex &bottomRight,
+                             const QModelIndex &parent, qint64 count)
+    {
+        // 变化范围比缓存还大时遍历缓存，否则逐个移除
+        if (count > cache->size()) {
+            const QList<QModelIndex> keys = cache->keys();
+            for (const QModelIndex &key : keys) {
+                if (isInRange(key, topLeft, bottomRight, parent))
+                    cache->remove(key);
+            }
+            return;
+        }
+
+        for (int row = topLeft.row(); row <= bottomRight.row(); ++row) {
+            for (int column = topLeft.column(); column <= bottomRight.column(); ++column)
+                cache->remove(cacheModel->index(row, column, parent));
+        }
+    }
+
+    // first 为 -1 时所有缓存项都可能受影响
+    static bool isMovingKey(const QModelIndex &key, const QModelIndex &parent, int first)
+    {
+        if (first < 0)
+            return true;
+
+        // 子项的 index 是否随祖先行号变化取决于模型的实现，一律视为受影响
+        return key.parent().isValid() || (key.parent() == parent && key.row() >= first);
+    }
+
+    // 模型结构变化前把受影响的缓存项转为 QPersistentModelIndex，由模型负责更新
+    void beginMoveItemCache(const QModelIndex &parent, int first)
+    {
+        for (auto it = sizeHintCache.begin(); it != sizeHintCache.end();) {
+            if (isMovingKey(it.key(), parent, first)) {
+                movingSizeHints.append(qMakePair(QPersistentModelIndex(it.key()), it.value()));
+                it = sizeHintCache.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        const QList<QModelIndex> keys = actionLayoutCache.keys();
+        for (const QModelIndex &key : keys) {
+            if (isMovingKey(key, parent, first))
+                movingActionLayouts.append(qMakePair(QPersistentModelIndex(key), actionLayoutCache.take(key)));
         }
     }
 
+    // 变化完成后按更新后的 index 放回，随列表项一起被移除的缓存项直接丢弃
+    void endMoveItemCache()
+    {
+        for (const auto &item : qAsConst(movingSizeHints)) {
+            if (item.first.isValid())
+                sizeHintCache.insert(item.first, item.second);
+        }
+        movingSizeHints.clear();
+
+        for (const auto &item : qAsConst(movingActionLayouts)) {
+            if (item.first.isValid()) {
+                actionLayoutCache.insert(item.first, item.second);
+            } else {
+                delete item.second;
+            }
+        }
+        movingActionLayouts.clear();
+    }
+
+    void clearItemCache()
+    {
+        sizeHintCache.clear();
+        uniformSizeHint = SizeHintEntry();
+        actionLayoutCache.clear();
+        movingSizeHints.clear();
+        for (const auto &item : qAsConst(movingActionLayouts))
+            delete item.second;
+        movingActionLayouts.clear();
+    }
+
     DStyledItemDelegate::BackgroundType backgroundType = DStyledItemDelegate::NoBackground;
     QMargins margins;
     QSize itemSize;
     int itemSpacing = 0;
+    QPointer<const QAbstractItemModel> cacheModel;
+    QList<QMetaObject::Connection> cacheModelConnections;
+    SizeHintOptionKey sizeHintKey;
+    QHash<QModelIndex, SizeHintEntry> sizeHintCache;
+    SizeHintEntry uniformSizeHint;
+    QCache<QModelIndex, ItemActionLayout> actionLayoutCache { ActionLayoutCacheSize };
+    QList<QPair<QPersistentModelIndex, SizeHintEntry>> movingSizeHints;
+    QList<QPair<QPersistentModelIndex, ItemActionLayout *>> movingActionLayouts;
     QMap<QModelIndex, QList<QPair<QAction*, QRect>>> clickableActionMap;
     QAction *pressedAction = nullptr;
     QList<QPointer<QWidget>> lastWidgets;
@@ -659,6 +1041,12 @@ DViewItemAction::DViewItemAction(Qt::Alignment alignment, const QSize &iconSize,
     d->iconSize = iconSize.isValid() ? iconSize : QSize(qApp->style()->pixelMetric(DStyle::PM_IndicatorWidth), qApp->style()->pixelMetric(DStyle::PM_IndicatorHeight));
     d->maxSize = maxSize;
     d->clickable = clickable;
+    d->touch();
+
+    // 文本、图标、字体及可见性变化都会触发 changed 信号
+    connect(this, &QAction::changed, this, [this]() {
+        d_func()->touch();
+    });
 }
 
 #if DTK_VERSION < DTK_VERSION_CHECK(6, 0, 0, 0)
@@ -725,6 +1113,7 @@ void DViewItemAction::setClickAreaMargins(const QMargins &margins)
     D_D(DViewItemAction);
 
     d->clickMargins = margins;
+    d->touch();
 }
 
 /*!
@@ -786,6 +1175,7 @@ void DViewItemAction::setFontSize(DFontSizeManager::SizeType size)
     D_D(DViewItemAction);
 
     d->fontSize = size;
+    d->touch();
 }
 
 /*!
@@ -800,7 +1190,16 @@ QFont DViewItemAction::font() const
         return QAction::font();
     }
 
-    return DFontSizeManager::instance()->get(static_cast<DFontSizeManager::SizeType>(d->fontSize), QAction::font());
+    const DFontSizeManager::SizeType type = static_cast<DFontSizeManager::SizeType>(d->fontSize);
+    const quint16 pixelSize = DFontSizeManager::instance()->fontPixelSize(type);
+
+    if (d->fontDirty || d->cachedFontPixelSize != pixelSize) {
+        d->cachedFont = DFontSizeManager::instance()->get(type, QAction::font());
+        d->cachedFontPixelSize = pixelSize;
+        d->fontDirty = false;
+    }
+
+    return d->cachedFont;
 }
 
 /*!
@@ -824,6 +1223,7 @@ void DViewItemAction::setWidget(QWidget *widget)
 
     d->widget = QPointer<QWidget>(widget);
     d->widget->setVisible(false);
+    d->touch();
 }
 
 /*!
@@ -842,6 +1242,7 @@ void DViewItemAction::setDciIcon(const DDciIcon &dciIcon)
     D_D(DViewItemAction);
 
     d->dciIcon = dciIcon;
+    d->touch();
 }
 
 DDciIcon DViewItemAction::dciIcon() const
@@ -894,6 +1295,11 @@ DStyledItemDelegate::DStyledItemDelegate(QAbstractItemView *parent)
     //支持QAction的点击
     parent->viewport()->installEventFilter(this);
 
+    connect(DGuiApplicationHelper::instance(), &DGuiApplicationHelper::sizeModeChanged, this, [this]() {
+        D_D(DStyledItemDelegate);
+        d->clearItemCache();
+    });
+
     // 初始化 background type. 注意 setBackgroundType() 中有额外的处理操作，所以不能直接简单的修改默认值
     setBackgroundType(DStyledItemDelegate::RoundedBackground);
 }
@@ -951,18 +1357,20 @@ void DStyledItemDelegate::paint(QPainter *painter, const QStyleOptionViewItem &o
     QRect itemContentRect = opt.rect;
     QSize action_area_size(0, 0);
     QList<QPair<QAction*, QRect>> clickActionList;
-    int spacing = DStyleHelper(qApp->style()).pixelMetric(DStyle::PM_ContentsSpacing);
+    // 拷贝一份，避免绘制过程中缓存被修改
+    const DStyledItemDelegatePrivate::ItemActionLayout action_layout = const_cast<DStyledItemDelegatePrivate*>(d)->itemActionLayout(opt, index);
+    int spacing = action_layout.spacing;
 
-    action_area_size = d->drawActions(painter, opt, index.data(Dtk::LeftActionListRole), Qt::LeftEdge, &clickActionList);
+    action_area_size = d->drawActions(painter, opt, action_layout.edges[0], spacing, &clickActionList);
     itemContentRect.setLeft(itemContentRect.left() + action_area_size.width() + (action_area_size.isNull() ? 0 : spacing));
 
-    action_area_size = d->drawActions(painter, opt, index.data(Dtk::RightActionListRole), Qt::RightEdge, &clickActionList);
+    action_area_size = d->drawActions(painter, opt, action_layout.edges[1], spacing, &clickActionList);
     itemContentRect.setRight(itemContentRect.right() - action_area_size.width() - (action_area_size.isNull() ? 0 : spacing));
 
-    action_area_size = d->drawActions(painter, opt, index.data(Dtk::TopActionListRole), Qt::TopEdge, &clickActionList);
+    action_area_size = d->drawActions(painter, opt, action_layout.edges[2], spacing, &clickActionList);
     itemContentRect.setTop(itemContentRect.top() + action_area_size.height() + (action_area_size.isNull() ? 0 : spacing));
 
-    action_area_size = d->drawActions(painter, opt, index.data(Dtk::BottomActionListRole), Qt::BottomEdge, &clickActionList);
+    action_area_size = d->drawActions(painter, opt, action_layout.edges[3], spacing, &clickActionList);
     itemContentRect.setBottom(itemContentRect.bottom() - action_area_size.height() - (action_area_size.isNull() ? 0 : spacing));
 
     if (!clickActionList.isEmpty()) {
@@ -971,7 +1379,8 @@ void DStyledItemDelegate::paint(QPainter *painter, const QStyleOptionViewItem &o
         const_cast<DStyledItemDelegatePrivate*>(d)->clickableActionMap.remove(index);
     }
 
-    const DViewItemActionList &text_action_list = qvariantToActionList(index.data(Dtk::TextActionListRole));
+    const DViewItemActionList &text_action_list = action_layout.textActions.isValid() ? action_layout.textActions.constData()->list
+                                                                                        : DViewItemActionList();
 
     opt.rect = itemContentRect;
     QRect iconRect, textRect, checkRect;
@@ -1038,7 +1447,7 @@ void DStyledItemDelegate::paint(QPainter *painter, const QStyleOptionViewItem &o
             opt.displayAlignment &= ~Qt::AlignVCenter;
             opt.displayAlignment &= ~Qt::AlignBottom;
 
-            QRect textRectbounding = d->textAndTextActionsLayout(textRect, style, opt, index);
+            QRect textRectbounding = d->textAndTextActionsLayout(textRect, style, opt, text_action_list);
 
             QRect bounding(textRectbounding.topLeft(), QSize());
             if (!opt.text.isEmpty()) {
@@ -1103,9 +1512,18 @@ void DStyledItemDelegate::paint(QPainter *painter, const QStyleOptionViewItem &o
         style->drawPrimitive(QStyle::PE_FrameFocusRect, &o, painter, widget);
     }
 
-    const_cast<DStyledItemDelegatePrivate*>(d)->recordVisibleWidgetOfCurrentFrame(index);
+    const_cast<DStyledItemDelegatePrivate*>(d)->recordVisibleWidgetOfCurrentFrame(action_layout);
 }
 
+/*!
+  \brief 返回 \a index 对应项的建议大小.
+
+  计算结果会按项缓存，模型数据、结构、字体或风格变化时自动失效。当视图开启了
+  QListView::uniformItemSizes 或模型设置了 "_d_dtk_uniformItemSizes" 属性为 true 时，
+  所有项共用第一次计算出的大小。
+
+  \sa QStyledItemDelegate::sizeHint()
+ */
 QSize DStyledItemDelegate::sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const
 {
     D_DC(DStyledItemDelegate);
@@ -1119,6 +1537,30 @@ QSize DStyledItemDelegate::sizeHint(const QStyleOptionViewItem &option, const QM
     if (value.isValid())
         return qvariant_cast<QSize>(value);
 
+    DStyledItemDelegatePrivate *dd = const_cast<DStyledItemDelegatePrivate *>(d);
+    dd->bindItemCacheModel(index.model());
+
+    const auto &optionKey = d->sizeHintOptionKey(option);
+    if (!(optionKey == d->sizeHintKey)) {
+        dd->clearItemCache();
+        dd->sizeHintKey = optionKey;
+    }
+
+    const bool uniform = d->hasUniformItemSizes(option, index);
+    if (uniform) {
+        if (d->uniformSizeHint.isValid())
+            return d->uniformSizeHint.size;
+    } else {
+        auto cached = d->sizeHintCache.constFind(index);
+        if (cached != d->sizeHintCache.constEnd() && cached->isValid())
+            return cached->size;
+    }
+
+    DStyledItemDelegatePrivate::SizeHintEntry entry;
+    entry.actions[0] = index.data(Dtk::TextActionListRole).value<ActionList>();
+    for (int i = 0; i < 4; ++i)
+        entry.actions[i + 1] = index.data(d->actionRoles[i]).value<ActionList>();
+
     const QWidget *widget = option.widget;
     QStyle *style = widget ? widget->style() : QApplication::style();
     QStyleOptionViewItem opt = option;
@@ -1126,7 +1568,7 @@ QSize DStyledItemDelegate::sizeHint(const QStyleOptionViewItem &option, const QM
     QRect pixmapRect, textRect, checkRect;
     DStyle::viewItemLayout(style, &opt, &pixmapRect, &textRect, &checkRect, true);
 
-    const DViewItemActionList &text_action_list = qvariantToActionList(index.data(Dtk::TextActionListRole));
+    const DViewItemActionList &text_action_list = actionListOf(entry.actions[0]);
 
     for (const DViewItemAction *action : text_action_list) {
         const QSize &action_size = d->displayActionSize(action, style, opt);
@@ -1136,10 +1578,10 @@ QSize DStyledItemDelegate::sizeHint(const QStyleOptionViewItem &option, const QM
 
     QSize size = (pixmapRect | textRect | checkRect).size();
 
-    const DViewItemActionList &left_actions = qvariantToActionList(index.data(Dtk::LeftActionListRole));
-    const DViewItemActionList &right_actions = qvariantToActionList(index.data(Dtk::RightActionListRole));
-    const DViewItemActionList &top_actions = qvariantToActionList(index.data(Dtk::TopActionListRole));
-    const DViewItemActionList &bottom_actions = qvariantToActionList(index.data(Dtk::BottomActionListRole));
+    const DViewItemActionList &left_actions = actionListOf(entry.actions[1]);
+    const DViewItemActionList &right_actions = actionListOf(entry.actions[2]);
+    const DViewItemActionList &top_actions = actionListOf(entry.actions[3]);
+    const DViewItemActionList &bottom_actions = actionListOf(entry.actions[4]);
 
     QSize action_area_size;
     // 获取左边区域大小
@@ -1183,7 +1625,20 @@ QSize DStyledItemDelegate::sizeHint(const QStyleOptionViewItem &option, const QM
         }
     }
 
-    return QRect(QPoint(0, 0), size).marginsAdded(margins).size();
+    size = QRect(QPoint(0, 0), size).marginsAdded(margins).size();
+
+    entry.size = size;
+    entry.revision = 0;
+    for (const ActionList &list : entry.actions)
+        d->actionsRevision(list, &entry.revision, &entry.widgetSizeSeed);
+
+    if (uniform) {
+        dd->uniformSizeHint = entry;
+    } else {
+        dd->sizeHintCache.insert(index, entry);
+    }
+
+    return size;
 }
 
 void DStyledItemDelegate::updateEditorGeometry(QWidget *editor, const QStyleOptionViewItem &option, const QModelIndex &index) const
@@ -1266,6 +1721,7 @@ void DStyledItemDelegate::setBackgroundType(DStyledItemDelegate::BackgroundType
 
     d->backgroundType = type;
     d->margins = QMargins();
+    d->clearItemCache();
 
     if (backgroundType() != NoBackground) {
         QStyle *style = qApp->style();
@@ -1285,6 +1741,7 @@ void DStyledItemDelegate::setMargins(const QMargins margins)
     D_D(DStyledItemDelegate);
 
     d->margins = margins;
+    d->clearItemCache();
 }
 
 void DStyledItemDelegate::setItemSize(QSize itemSize)
@@ -1292,6 +1749,7 @@ void DStyledItemDelegate::setItemSize(QSize itemSize)
     D_D(DStyledItemDelegate);
 
     d->itemSize = itemSize;
+    d->clearItemCache();
 }
 
 void DStyledItemDelegate::setItemSpacing(int spacing)
@@ -1299,6 +1757,7 @@ void DStyledItemDelegate::setItemSpacing(int spacing)
     D_D(DStyledItemDelegate);
 
     d->itemSpacing = spacing;
+    d->clearItemCache();
 }
 
 void DStyledItemDelegate::initStyleOption(QStyleOptionViewItem *option, const QModelIndex &index) const
@@ -1426,8 +1885,13 @@ bool DStyledItemDelegate::eventFilter(QObject *object, QEvent *event)
         break;
     }
     const auto view = qobject_cast<QAbstractItemView*>(parent());
+    if (event->type() == QEvent::FontChange && view) {
+        D_D(DStyledItemDelegate);
+        d->clearItemCache();
+    }
     if (event->type() == QEvent::StyleChange && view) {
         D_D(DStyledItemDelegate);
+        d->clearItemCache();
         do {
             if (d->margins.isNull())
                 break;
@@ -3,6 +3,7 @@
 // SPDX-License-Identifier: LGPL-3.0-or-later
 
 #include "dwatermarkwidget.h"
+#include "private/dwatermarkwidget_p.h"
 
 #include <DObjectPrivate>
 #include <DWidgetUtil>
@@ -10,9 +11,12 @@
 #include <QPainter>
 #include <QResizeEvent>
 #include <QDebug>
+#include <QtMath>
+#include <QCache>
 
 #include <cmath>
 
+
 DCORE_USE_NAMESPACE
 DTK_USE_NAMESPACE
 DWIDGET_BEGIN_NAMESPACE
@@ -397,45 +401,119 @@ static QImage createTextureImage(const WaterMarkData &data, qreal deviceScale)
     return texture;
 }
 
-void drawWaterTexture(QPainter &painter, const QImage &texture, qreal rotation, const QRect &paintRect)
+// 将旋转后的纹理排布到一张水平和竖直方向都可以无缝平铺的图片中，绘制时无需再变换画刷
+QBrush DWaterMarkWidgetPrivate::createTextureBrush(const QImage &texture, qreal rotation)
 {
-    painter.save();
-    painter.setRenderHint(QPainter::SmoothPixmapTransform);
-    painter.setRenderHint(QPainter::Antialiasing);
+    if (texture.isNull())
+        return QBrush();
+
+    const qreal radian = qDegreesToRadians(rotation);
+    const qreal cosValue = qCos(radian);
+    const qreal sinValue = qSin(radian);
+    const int width = texture.width();
+    const int height = texture.height();
+
+    // 以更接近文字方向的坐标轴为主轴，点阵由副轴方向的 (step) 和沿文字方向的 (mainStep, shift) 生成，
+    // 两者围成的面积与原纹理一致，行距保持不变
+    const bool majorIsX = qAbs(cosValue) >= qAbs(sinValue);
+    const qreal majorCos = majorIsX ? qAbs(cosValue) : qAbs(sinValue);
+    qreal main = width * (majorIsX ? cosValue : sinValue);
+    qreal cross = width * (majorIsX ? sinValue : cosValue);
+    if (main < 0) {
+        main = -main;
+        cross = -cross;
+    }
 
-    // 旋转画刷,避免调整父界面大小时水印内容有移动
-    QBrush b;
-    b.setTextureImage(texture);
-    QPoint center = texture.rect().center();
-    QTransform t = QTransform()
-            .translate(center.x(), center.y())
-            .rotate(rotation)
-            .translate(-center.x(), -center.y());
-    b.setTransform(t);
+    const int mainStep = qMax(1, qRound(main));
+    const int step = qMax(1, qCeil(height / majorCos));
+    const qreal target = std::fmod(std::fmod(cross, step) + step, step);
+
+    // 行偏移取 step * j / k，k 行之后回到起点，得到 k * mainStep 的周期
+    int bestJ = 0, bestK = 1;
+    qreal bestError = step;
+    for (int k = 1; k <= WATERMARK_TILE_MAX_ROWS && (k == 1 || k * mainStep <= WATERMARK_TILE_MAX_SIZE) && bestError > 0.25; ++k) {
+        const int j = qRound(target * k / step);
+        const qreal error = qAbs(static_cast<qreal>(step) * j / k - target);
+        if (error < bestError) {
+            bestError = error;
+            bestJ = j;
+            bestK = k;
+        }
+    }
+
+    const qreal shift = static_cast<qreal>(step) * bestJ / bestK;
+    auto toPoint = [majorIsX](qreal major, qreal minor) {
+        return majorIsX ? QPointF(major, minor) : QPointF(minor, major);
+    };
+
+    const QSize tileSize = majorIsX ? QSize(bestK * mainStep, step) : QSize(step, bestK * mainStep);
+    const int majorSize = bestK * mainStep;
+    QImage tile(tileSize, QImage::Format_ARGB32_Premultiplied);
+    tile.fill(Qt::transparent);
+
+    // 与旋转画刷的锚点一致，调整父界面大小时水印内容不会移动
+    const QPointF center = texture.rect().center();
+    const QPointF origin = center - QTransform().rotate(rotation).map(center);
+    const qreal originMajor = majorIsX ? origin.x() : origin.y();
+    const qreal originMinor = majorIsX ? origin.y() : origin.x();
+    const qreal radius = std::hypot(width, height) + 1;
+
+    QPainter tp(&tile);
+    tp.setRenderHint(QPainter::SmoothPixmapTransform);
+    tp.setRenderHint(QPainter::Antialiasing);
+    const int firstColumn = qFloor((-radius - originMajor) / mainStep);
+    const int lastColumn = qCeil((majorSize + radius - originMajor) / mainStep);
+    for (int n = firstColumn; n <= lastColumn; ++n) {
+        const qreal major = originMajor + n * mainStep;
+        const qreal minor = originMinor + n * shift;
+        const int firstRow = qFloor((-radius - minor) / step);
+        const int lastRow = qCeil((step + radius - minor) / step);
+        for (int i = firstRow; i <= lastRow; ++i) {
+            const QPointF &point = toPoint(major, minor + i * step);
+            tp.setTransform(QTransform().translate(point.x(), point.y()).rotate(rotation));
+            tp.drawImage(0, 0, texture);
+        }
+    }
+    tp.end();
 
-//    painter.setPen(Qt::NoPen);
-    painter.setBrush(b);
-    painter.drawRect(paintRect);
-    painter.restore();
+    return QBrush(tile);
 }
 
-class DWaterMarkWidgetPrivate: public DTK_CORE_NAMESPACE::DObjectPrivate
+// 生成平铺纹理所依赖的全部参数，透明度在绘制时处理，不影响纹理
+static QString textureKey(const WaterMarkData &data, qreal deviceScale)
 {
-protected:
-    explicit DWaterMarkWidgetPrivate(DWaterMarkWidget *parent)
-        : DObjectPrivate(parent)
-    {
+    return QStringList {
+        QString::number(data.type()),
+        QString::number(data.scaleFactor()),
+        QString::number(data.spacing()),
+        QString::number(data.lineSpacing()),
+        data.text(),
+        data.font().toString(),
+        QString::number(data.color().rgba()),
+        QString::number(data.rotation()),
+        QString::number(data.image().cacheKey()),
+        QString::number(data.grayScale()),
+        QString::number(deviceScale)
+    }.join(QLatin1Char('|'));
+}
 
-    }
+// 相同配置和缩放比的水印界面（如 DWaterMarkHelper 为每个窗口创建的水印）共享同一份纹理
+static QBrush sharedTextureBrush(const WaterMarkData &data, qreal deviceScale)
+{
+    static QCache<QString, QBrush> textureCache(WATERMARK_TEXTURE_CACHE_LIMIT);
 
-private:
-    void init();
+    const QString &key = textureKey(data, deviceScale);
+    if (QBrush *brush = textureCache.object(key))
+        return *brush;
 
-    WaterMarkData data;
-    QImage textureImage;
+    const QBrush &brush = DWaterMarkWidgetPrivate::createTextureBrush(createTextureImage(data, deviceScale), data.rotation());
+    const QImage &tile = brush.textureImage();
+    // 以 KB 为单位计算缓存开销
+    const int cost = qMax<qint64>(1, static_cast<qint64>(tile.width()) * tile.height() * tile.depth() / 8 / 1024);
+    textureCache.insert(key, new QBrush(brush), cost);
 
-    D_DECLARE_PUBLIC(DWaterMarkWidget)
-};
+    return brush;
+}
 
 void DWaterMarkWidgetPrivate::init()
 {
@@ -446,6 +524,51 @@ void DWaterMarkWidgetPrivate::init()
     q->setFocusPolicy(Qt::NoFocus);
 }
 
+const QBrush &DWaterMarkWidgetPrivate::tiledBrush(qreal deviceScale)
+{
+    // 仅在配置或屏幕缩放改变后重新获取纹理
+    if (!qFuzzyCompare(textureScale, deviceScale)) {
+        textureBrush = sharedTextureBrush(data, deviceScale);
+        textureScale = deviceScale;
+    }
+
+    return textureBrush;
+}
+
+QImage DWaterMarkWidgetPrivate::centerImage(qreal deviceScale)
+{
+    const QImage &source = data.image();
+    const int width = qRound(source.width() * data.scaleFactor() * deviceScale);
+    const QString key = QStringLiteral("%1:%2:%3:%4:%5")
+            .arg(source.cacheKey())
+            .arg(width)
+            .arg(data.grayScale())
+            .arg(data.opacity())
+            .arg(deviceScale);
+
+    // 参数不变时直接使用缓存，避免每次绘制都重新灰度化和缩放图片
+    if (key == centerImageKey)
+        return centerImageCache;
+
+    QImage img = source;
+    if (data.grayScale())
+        DWIDGET_NAMESPACE::grayScale(source, img, source.rect());
+    img = img.scaledToWidth(width);
+
+    // 透明度预先合成到图片中，绘制时直接贴图
+    QImage cache(img.size(), QImage::Format_ARGB32_Premultiplied);
+    cache.setDevicePixelRatio(img.devicePixelRatio());
+    cache.fill(Qt::transparent);
+    QPainter painter(&cache);
+    painter.setOpacity(data.opacity());
+    painter.drawImage(0, 0, img);
+    painter.end();
+
+    centerImageCache = cache;
+    centerImageKey = key;
+    return centerImageCache;
+}
+
 /*!
   \class Dtk::Widget::DWaterMarkWidget
   \inmodule dtkwidget
@@ -480,7 +603,7 @@ void DWaterMarkWidget::setData(const WaterMarkData &data)
     D_D(DWaterMarkWidget);
 
     d->data = data;
-    d->textureImage = createTextureImage(d->data, devicePixelRatioF());
+    d->textureScale = 0;
 
     update();
 }
@@ -518,7 +641,7 @@ void DWaterMarkWidget::paintEvent(QPaintEvent *)
             painter.drawText(rect(), Qt::AlignCenter, d->data.text());
             painter.restore();
         } else {
-            drawWaterTexture(painter, d->textureImage, d->data.rotation(), rect());
+            painter.fillRect(rect(), d->tiledBrush(deviceScale));
         }
         break;
     }
@@ -529,11 +652,9 @@ void DWaterMarkWidget::paintEvent(QPaintEvent *)
 
         // 居中处理
         if (d->data.layout() == WaterMarkData::Center) {
-            // 缩放处理
-            QImage img = d->data.image();
-            if (d->data.grayScale())
-                DWIDGET_NAMESPACE::grayScale(d->data.image(), img, d->data.image().rect());
-            img = img.scaledToWidth(qRound(img.width() * d->data.scaleFactor() * deviceScale));
+            // 缩放处理，透明度已合成到图片中
+            const QImage &img = d->centerImage(deviceScale);
+            painter.setOpacity(1);
             QSize size = img.size() / img.devicePixelRatio();
             int imgWidth = size.width();
             int imgHeight = size.height();
@@ -546,7 +667,7 @@ void DWaterMarkWidget::paintEvent(QPaintEvent *)
             QPointF leftTop(rect().center().x() - imgWidth / 2.0, rect().center().y() - imgHeight / 2.0);
             painter.drawImage(leftTop, img);
         } else {
-            drawWaterTexture(painter, d->textureImage, d->data.rotation(), rect());
+            painter.fillRect(rect(), d->tiledBrush(deviceScale));
         }
         break;
     }
@@ -12,6 +12,8 @@
 #include <QEvent>
 #include <QIcon>
 #include <QLinearGradient>
+#include <QPointer>
+#include <QWindow>
 
 #include <DIconTheme>
 #include <DObjectPrivate>
@@ -43,15 +45,23 @@ public:
     }
 
     void resizePixmap(QSize sz);
+    void resizeBuffers(const QSize &sz);
     void initUI();
     void setValue(int v);
     void paint(QPainter *p);
+    void updateTimerState();
+    void watchWindow();
 
     QImage waterFrontImage;
     QImage waterBackImage;
+    QImage waterImage;          // 每帧复用的绘制缓冲区
+    QImage backgroundImage;     // 渐变背景圆，不随动画变化
+    QImage maskImage;           // 圆形遮罩，不随动画变化
     QString progressText;
     QTimer *timer = Q_NULLPTR;
     QList<Pop> pops;
+    QPointer<QWindow> watchedWindow;
+    QMetaObject::Connection visibilityConnection;
 
     int     interval = 33;
     int     value = -1;
@@ -60,6 +70,7 @@ public:
     double  backXOffset = 0;
 
     bool    textVisible = true;
+    bool    running = false;    // 是否调用了 start，界面不可见时暂停动画但保留该状态
 
     D_DECLARE_PUBLIC(DWaterProgress)
 };
@@ -110,8 +121,9 @@ int DWaterProgress::value() const
  */
 void DWaterProgress::start()
 {
-    D_DC(DWaterProgress);
-    d->timer->start();
+    D_D(DWaterProgress);
+    d->running = true;
+    d->updateTimerState();
 }
 
 /*!
@@ -120,7 +132,8 @@ void DWaterProgress::start()
  */
 void DWaterProgress::stop()
 {
-    D_DC(DWaterProgress);
+    D_D(DWaterProgress);
+    d->running = false;
     d->timer->stop();
 }
 
@@ -168,6 +181,59 @@ void DWaterProgress::changeEvent(QEvent *e)
     return QWidget::changeEvent(e);
 }
 
+void DWaterProgress::showEvent(QShowEvent *e)
+{
+    D_D(DWaterProgress);
+    d->watchWindow();
+    d->updateTimerState();
+
+    QWidget::showEvent(e);
+}
+
+void DWaterProgress::hideEvent(QHideEvent *e)
+{
+    D_D(DWaterProgress);
+    // 隐藏时暂停动画，再次显示时根据 running 恢复
+    d->timer->stop();
+
+    QWidget::hideEvent(e);
+}
+
+void DWaterProgressPrivate::updateTimerState()
+{
+    D_Q(DWaterProgress);
+
+    bool visible = q->isVisible();
+    if (QWindow *window = q->window()->windowHandle()) {
+        const QWindow::Visibility visibility = window->visibility();
+        visible = visible && visibility != QWindow::Minimized && visibility != QWindow::Hidden;
+    }
+
+    if (running && visible) {
+        if (!timer->isActive())
+            timer->start();
+    } else {
+        timer->stop();
+    }
+}
+
+void DWaterProgressPrivate::watchWindow()
+{
+    D_Q(DWaterProgress);
+
+    // 所在窗口最小化时子控件不会收到隐藏事件，需要监听窗口的可见状态
+    QWindow *window = q->window()->windowHandle();
+    if (window == watchedWindow)
+        return;
+
+    QObject::disconnect(visibilityConnection);
+    watchedWindow = window;
+    if (window)
+        visibilityConnection = QObject::connect(window, &QWindow::visibilityChanged, q, [this] {
+            updateTimerState();
+        });
+}
+
 void DWaterProgressPrivate::resizePixmap(QSize sz)
 {
     // resize water;
@@ -193,6 +259,48 @@ void DWaterProgressPrivate::resizePixmap(QSize sz)
     }
 }
 
+void DWaterProgressPrivate::resizeBuffers(const QSize &sz)
+{
+    // 缓冲区按设备像素分配，控件尺寸和缩放比不变时直接复用
+    if (waterImage.size() == sz)
+        return;
+
+    waterImage = QImage(sz, QImage::Format_ARGB32_Premultiplied);
+
+    // 渐变背景
+    backgroundImage = QImage(sz, QImage::Format_ARGB32_Premultiplied);
+    backgroundImage.fill(Qt::transparent);
+    QPainter backgroundPainter(&backgroundImage);
+    backgroundPainter.setRenderHint(QPainter::Antialiasing);
+    backgroundPainter.setCompositionMode(QPainter::CompositionMode_Source);
+
+    QPointF pointStart(sz.width() / 2, 0);
+    QPointF pointEnd(sz.width() / 2, sz.height());
+    QLinearGradient linear(pointStart, pointEnd);
+    QColor startColor("#1F08FF");
+    startColor.setAlphaF(1);
+    QColor endColor("#50FFF7");
+    endColor.setAlphaF(0.28);
+    linear.setColorAt(0, startColor);
+    linear.setColorAt(1, endColor);
+    linear.setSpread(QGradient::PadSpread);
+    backgroundPainter.setPen(Qt::NoPen);
+    backgroundPainter.setBrush(linear);
+    backgroundPainter.drawEllipse(backgroundImage.rect().center(), sz.width() / 2 + 1, sz.height() / 2  + 1);
+    backgroundPainter.end();
+
+    // 圆形遮罩
+    maskImage = QImage(sz, QImage::Format_ARGB32_Premultiplied);
+    maskImage.fill(Qt::transparent);
+    QPainterPath path;
+    path.addEllipse(QRectF(0, 0, sz.width(), sz.height()));
+    QPainter maskPainter(&maskImage);
+    maskPainter.setRenderHint(QPainter::Antialiasing);
+    maskPainter.setPen(QPen(Qt::white, 1));
+    maskPainter.fillPath(path, QBrush(Qt::white));
+    maskPainter.end();
+}
+
 void DWaterProgressPrivate::initUI()
 {
     D_Q(DWaterProgress);
@@ -264,29 +372,21 @@ void DWaterProgressPrivate::paint(QPainter *p)
     QRectF rect = QRectF(0, 0, q->width() * pixelRatio, q->height() * pixelRatio);
     QSize sz = QSizeF(q->width() * pixelRatio, q->height() * pixelRatio).toSize();
 
+    // 尚未布局时没有可绘制的区域，避免在空图像上绘制
+    if (sz.isEmpty())
+        return;
+
     resizePixmap(sz);
 
     int yOffset = rect.toRect().topLeft().y() + (100 - value - 10)  * sz.height() / 100;
 
-    // draw water
-    QImage waterImage = QImage(sz, QImage::Format_ARGB32_Premultiplied);
+    resizeBuffers(sz);
+
+    // draw water，缓冲区在每帧之间复用，背景直接拷贝
     QPainter waterPinter(&waterImage);
     waterPinter.setRenderHint(QPainter::Antialiasing);
     waterPinter.setCompositionMode(QPainter::CompositionMode_Source);
-
-    QPointF pointStart(sz.width() / 2, 0);
-    QPointF pointEnd(sz.width() / 2, sz.height());
-    QLinearGradient linear(pointStart, pointEnd);
-    QColor startColor("#1F08FF");
-    startColor.setAlphaF(1);
-    QColor endColor("#50FFF7");
-    endColor.setAlphaF(0.28);
-    linear.setColorAt(0, startColor);
-    linear.setColorAt(1, endColor);
-    linear.setSpread(QGradient::PadSpread);
-    waterPinter.setPen(Qt::NoPen);
-    waterPinter.setBrush(linear);
-    waterPinter.drawEllipse(waterImage.rect().center(), sz.width() / 2 + 1, sz.height() / 2  + 1);
+    waterPinter.drawImage(0, 0, backgroundImage);
 
     waterPinter.setCompositionMode(QPainter::CompositionMode_SourceOver);
     waterPinter.drawImage(static_cast<int>(backXOffset), yOffset, waterBackImage);
@@ -360,31 +460,12 @@ void DWaterProgressPrivate::paint(QPainter *p)
             waterPinter.drawText(rectPerent, Qt::AlignCenter, "%");
         }
     }
+    // 使用圆形遮罩裁剪，与在遮罩上以 SourceIn 绘制结果一致
+    waterPinter.setCompositionMode(QPainter::CompositionMode_DestinationIn);
+    waterPinter.drawImage(0, 0, maskImage);
     waterPinter.end();
 
-    QPixmap maskPixmap(sz);
-    maskPixmap.fill(Qt::transparent);
-    QPainterPath path;
-    path.addEllipse(QRectF(0, 0, sz.width(), sz.height()));
-    QPainter maskPainter(&maskPixmap);
-    maskPainter.setRenderHint(QPainter::Antialiasing);
-    maskPainter.setPen(QPen(Qt::white, 1));
-    maskPainter.fillPath(path, QBrush(Qt::white));
-
-    QPainter::CompositionMode mode = QPainter::CompositionMode_SourceIn;
-    QImage contentImage = QImage(sz, QImage::Format_ARGB32_Premultiplied);
-    QPainter contentPainter(&contentImage);
-    contentPainter.setCompositionMode(QPainter::CompositionMode_Source);
-    contentPainter.fillRect(contentImage.rect(), Qt::transparent);
-    contentPainter.setCompositionMode(QPainter::CompositionMode_SourceOver);
-    contentPainter.drawImage(0, 0, maskPixmap.toImage());
-    contentPainter.setCompositionMode(mode);
-    contentPainter.drawImage(0, 0, waterImage);
-    contentPainter.setCompositionMode(QPainter::CompositionMode_DestinationOver);
-    contentPainter.end();
-
-    contentImage.setDevicePixelRatio(pixelRatio);
-    p->drawImage(q->rect(), contentImage);
+    p->drawImage(q->rect(), waterImage);
 }
 
 DWIDGET_END_NAMESPACE
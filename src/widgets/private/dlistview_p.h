@@ -9,6 +9,9 @@
 
 #include <DObjectPrivate>
 
+#include <QList>
+#include <QTimer>
+
 DWIDGET_BEGIN_NAMESPACE
 
 class DBoxWidget;
@@ -21,12 +24,33 @@ class DListViewPrivate : public DTK_CORE_NAMESPACE::DObjectPrivate
 
     void onOrientationChanged();
 
+    struct PopulationRequest
+    {
+        int row = -1; // 小于 0 时表示追加到末尾
+        int offset = 0;
+        QVariantList items;
+        bool fetchMore = false;
+    };
+
+    void enqueuePopulation(PopulationRequest &&request);
+    void populateSlice();
+    void clearPopulation();
+
     DBoxWidget *headerLayout = nullptr;
     DBoxWidget *footerLayout = nullptr;
 
     QList<QWidget*> headerList;
     QList<QWidget*> footerList;
 
+    QTimer *populationTimer = nullptr;
+    QList<PopulationRequest> populationQueue;
+    int populationBudget = 8; // ms, 保证单次插入不超过半帧
+    int populationBatch = 64;
+    int populationInserted = 0;
+    int populationTotal = 0;
+    int populationPendingFetch = 0;
+    quint32 populationGeneration = 0;
+
 #if(QT_VERSION < 0x050500)
     int left = 0, top = 0, right = 0, bottom = 0; // viewport margin
 #endif
@@ -18,6 +18,12 @@
 #include <DComboBox>
 #include <DRadioButton>
 #include <QBasicTimer>
+#include <QElapsedTimer>
+#include <QFutureWatcher>
+#include <QPageSize>
+#include <QPrinter>
+
+#define PRINTER_INFO_CACHE_TTL (30 * 1000) // 打印机列表及属性缓存的有效期，单位毫秒
 
 class QVBoxLayout;
 class QButtonGroup;
@@ -38,6 +44,40 @@ class DSlider;
 class DBackgroundGroup;
 class DToolButton;
 class PreviewSettingsPluginHelper;
+
+// 打印机支持的属性，在后台线程中查询
+struct PrinterCapabilities
+{
+    QList<QPageSize> pageSizes;
+    QList<QPrinter::DuplexMode> duplexModes;
+    bool supportsColor = false;
+    bool supportsGrayscale = false;
+
+    inline bool operator==(const PrinterCapabilities &other) const
+    {
+        return pageSizes == other.pageSizes && duplexModes == other.duplexModes
+                && supportsColor == other.supportsColor && supportsGrayscale == other.supportsGrayscale;
+    }
+    inline bool operator!=(const PrinterCapabilities &other) const
+    {
+        return !(*this == other);
+    }
+};
+
+// 进程内共享的打印机信息，超过 PRINTER_INFO_CACHE_TTL 后在后台刷新
+struct PrinterInfoSnapshot
+{
+    QStringList printerNames;
+    QString defaultPrinterName;
+    QHash<QString, PrinterCapabilities> capabilities;
+    QElapsedTimer loadedTimer;
+
+    inline bool isExpired() const
+    {
+        return !loadedTimer.isValid() || loadedTimer.hasExpired(PRINTER_INFO_CACHE_TTL);
+    }
+};
+
 class DPrintPreviewDialogPrivate : public DDialogPrivate
 {
 public:
@@ -92,6 +132,9 @@ public:
     void setPageLayoutEnable(const bool &checked);
     void matchFitablePageSize();
     bool isActualPrinter(const QString &name);
+    void refreshPrinterInfo();// 缓存过期时在后台重新查询打印机信息，不阻塞界面
+    void applyPrinterInfo(const PrinterInfoSnapshot &info, bool selectDefault);
+    void printerInfoLoaded();// 后台查询完成后更新打印机列表及当前打印机属性
 
     void _q_printerChanged(int index);
     void _q_pageRangeChanged(int index);
@@ -196,6 +239,8 @@ public:
     QHash<QWidget *, QString> spinboxTextCaches;
     PreviewSettingsPluginHelper *settingHelper;
     QBasicTimer settingUpdateTimer;
+    PrinterInfoSnapshot printerInfo; // 当前界面使用的打印机信息
+    QFutureWatcher<PrinterInfoSnapshot> *printerInfoWatcher = nullptr;
     Q_DECLARE_PUBLIC(DPrintPreviewDialog)
 };
 
@@ -16,6 +16,12 @@
 #include <QPicture>
 #include <qmath.h>
 #include <QBasicTimer>
+#include <QCache>
+#include <QFutureWatcher>
+
+QT_BEGIN_NAMESPACE
+class QStandardItemModel;
+QT_END_NAMESPACE
 
 DWIDGET_BEGIN_NAMESPACE
 
@@ -28,7 +34,15 @@ DWIDGET_BEGIN_NAMESPACE
 #define PREVIEW_WATER_COUNT_SPACE 10
 #define NUMBERUP_SCALE_RATIO 1.05
 #define NUMBERUP_SPACE_SCALE_RATIO 0.05
-
+#define PREVIEW_PAGE_CACHE_LIMIT (64 * 1024) // 异步预览页面缓存上限，单位KB
+#define PREVIEW_GRAYSCALE_CACHE_LIMIT (64 * 1024) // 灰度页面缓存上限，单位KB
+#define PREVIEW_WATERMARK_CACHE_LIMIT (32 * 1024) // 打印水印图像缓存上限，单位KB
+#define PREVIEW_NUMBERUP_SHEET_CACHE_LIMIT (64 * 1024) // 并打拼版页面缓存上限，单位KB
+#define PREVIEW_IMAGE_PRINT_MEMORY_LIMIT (256 * 1024) // 打印为图片时同时光栅化的页面内存上限，单位KB
+#define PREVIEW_EXPORT_CHUNK_PAGES 8 // 异步导出PDF时每次请求的页面数量
+#define PREVIEW_THUMBNAIL_WIDTH 120 // 缩略图宽度
+
+class DListView;
 class GraphicsView : public QGraphicsView
 {
     Q_OBJECT
@@ -84,16 +98,16 @@ public:
     void paint(QPainter *painter, const QStyleOptionGraphicsItem *item, QWidget *widget) override;
     void updateGrayContent();
     void drawNumberUpPictures(QPainter *painter);
+    QImage grayscaleImage();
 
 protected:
-    QPicture grayscalePaint(const QPicture &picture);
+    QImage grayscalePaint(const QPicture &picture);
     QImage imageGrayscale(const QImage *origin);
 
 private:
     const QPicture *pagePicture;
     QRect pageRect;
     QRectF brect;
-    QPicture grayPicture;
 };
 
 class WaterMark : public QGraphicsItem
@@ -199,6 +213,8 @@ private:
 
     QPolygonF brectPolygon;
     QPolygonF twoPolygon;
+    QImage textTileImage; // 平铺文字水印的纹理
+    QString textTileKey; // 纹理对应的字体、颜色、文本和间距
     friend class DPrintPreviewWidgetPrivate;
 };
 
@@ -259,6 +275,7 @@ public:
     void updatePageByPagePrintVector(QVector<int> &pageVector, QList<const QPicture *> &pictures) const;
     void asynPrint(const QPointF &leftTop, const QRect &pageRect, const QVector<int> &pageVector);
     void syncPrint(const QPointF &leftTop, const QRect &pageRect, const QVector<int> &pageVector);
+    void streamPrint(const QPointF &leftTop, const QRect &pageRect, const QVector<int> &pageVector, const QVector<int> &printPages);
     void printAsImage(const QSize &paperSize, QVector<int> &pageVector);
     void printSinglePageDrawUtil(QPainter *painter, const QSize &translateSize, const QPointF &leftTop, const QImage &waterImage, const QPicture *picture);
     void printMultiPageDrawUtil(QPainter *painter, const QPointF &leftTop, const QImage &waterImage);
@@ -274,10 +291,20 @@ public:
 #endif
     int impositionPages(DPrintPreviewWidget::Imposition im); // 每页版数
     QImage generateWaterMarkImage() const;
-    PrintOptions printerOptions();
-    void printByCups();
+    QString waterMarkImageKey() const;// 生成水印图像所依赖的全部参数
+    PrintOptions printerOptions(bool resolveColorModel = true);// resolveColorModel为false时不查询打印机的颜色模式
+    void printByCups();// 在工作线程中提交打印任务，完成后发送printJobSubmitted或printJobFailed信号
 
     void generatePreviewPicture();// 发送requestPaint信号，重新获取原文档数据
+    QList<QPicture> fetchPreviewPages(const QVector<int> &pageVector, DPrinter *printer = nullptr);// 异步模式下优先从缓存中获取页面，仅请求缺失的页面
+    void prefetchNeighbourPages();// 异步模式下预先渲染当前页前后相邻的页面
+    QString grayscaleCacheKey();// 当前预览内容（页码、拼版、分辨率）对应的灰度缓存键值
+    QString numberUpSheetKey(qreal deviceScale);// 当前并打页面（页码、拼版、顺序、缩放、设备像素比）对应的缓存键值
+    QVector<int> sheetSourcePages(int sheet);// 预览第sheet页包含的原文档页码
+    void initThumbnailBar();
+    void resetThumbnails();// 页面数量或内容发生变化时重建缩略图列表，并同步当前页
+    int nextThumbnailRow();// 优先返回可见范围内未生成的缩略图
+    void renderNextThumbnail();
     void calculateNumberUpPage();// 重绘页面，当拼版数改变、纸张大小等操作时必须调用，
     void calculateNumberPagePosition();// 计算每小页面的显示位置
 
@@ -298,7 +325,7 @@ public:
     GraphicsView *graphicsView;
     QGraphicsScene *scene;
 
-    QList<QPicture> targetPictures;
+    QList<QPicture> targetPictures; // 异步模式下pictures所指向的页面数据，不受缓存淘汰影响
     QList<const QPicture *> pictures;
     QList<QGraphicsItem *> pages;
     QGraphicsRectItem *background;
@@ -328,6 +355,20 @@ public:
     struct NumberUpData;
     NumberUpData *numberUpPrintData;
     QBasicTimer updateTimer;
+    QBasicTimer prefetchTimer;
+    bool exportCanceled = false;
+    bool exporting = false; // 分批导出PDF期间会处理事件，需要防止重入
+    int previewGeneration = 0; // 每次重新生成预览时递增，用于判断缩略图是否失效
+    DListView *thumbnailView = nullptr;
+    QStandardItemModel *thumbnailModel = nullptr;
+    QFutureWatcher<QImage> *thumbnailWatcher = nullptr;
+    QBasicTimer thumbnailTimer;
+    QString thumbnailSignature;
+    int thumbnailRow = -1; // 正在后台生成的缩略图
+    QCache<int, QPicture> pageCache; // 异步模式下已渲染页面的LRU缓存（页码，页面），开销以KB计
+    QCache<QString, QImage> grayscaleCache; // 灰度预览页面缓存，开销以KB计
+    QCache<QString, QImage> numberUpSheetCache; // 拼接完成的并打页面缓存，开销以KB计
+    mutable QCache<QString, QImage> waterMarkImageCache; // 打印水印图像缓存，开销以KB计
     Q_DECLARE_PUBLIC(DPrintPreviewWidget)
 };
 
@@ -0,0 +1,49 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef DWATERMARKWIDGET_P_H
+#define DWATERMARKWIDGET_P_H
+
+#include <dwatermarkwidget.h>
+
+#include <DObjectPrivate>
+
+#include <QBrush>
+#include <QImage>
+
+#define WATERMARK_TILE_MAX_ROWS 16      // 平铺纹理中最多包含的行数
+#define WATERMARK_TILE_MAX_SIZE 4096    // 平铺纹理的最大边长
+#define WATERMARK_TEXTURE_CACHE_LIMIT (32 * 1024) // 进程内共享的平铺纹理缓存上限，单位KB
+
+DWIDGET_BEGIN_NAMESPACE
+
+class DWaterMarkWidgetPrivate: public DTK_CORE_NAMESPACE::DObjectPrivate
+{
+protected:
+    explicit DWaterMarkWidgetPrivate(DWaterMarkWidget *parent)
+        : DObjectPrivate(parent)
+    {
+
+    }
+
+public:
+    static QBrush createTextureBrush(const QImage &texture, qreal rotation);
+
+private:
+    void init();
+    QImage centerImage(qreal deviceScale);
+    const QBrush &tiledBrush(qreal deviceScale);
+
+    WaterMarkData data;
+    QBrush textureBrush;                // 平铺布局下预先旋转、可无缝平铺的纹理画刷
+    qreal textureScale = 0;             // 生成 textureBrush 时的缩放比，为 0 表示需要重新获取
+    QImage centerImageCache;            // 居中布局下经过灰度、缩放及透明度处理的图片
+    QString centerImageKey;             // 生成 centerImageCache 所依赖的参数
+
+    D_DECLARE_PUBLIC(DWaterMarkWidget)
+};
+
+DWIDGET_END_NAMESPACE
+
+#endif // DWATERMARKWIDGET_P_H
@@ -0,0 +1,158 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include <DApplication>
+#include <DPrintPreviewWidget>
+
+#include <QFile>
+#include <QPainter>
+#include <QtTest>
+
+DWIDGET_USE_NAMESPACE
+
+enum PreviewMode {
+    ColorMode,
+    GrayscaleMode,
+    WaterMarkMode,
+    NumberUpMode
+};
+Q_DECLARE_METATYPE(PreviewMode)
+
+// 合成文档的单页内容，包含文字、矢量图形和填充，接近一般文档的绘制开销
+static void drawSyntheticPage(QPainter *painter, int page)
+{
+    painter->setPen(Qt::black);
+    painter->drawText(QPointF(40, 40), QStringLiteral("Page %1").arg(page));
+    for (int line = 0; line < 40; ++line)
+        painter->drawText(QPointF(40, 80 + line * 16), QStringLiteral("Synthetic document line %1 of page %2").arg(line).arg(page));
+
+    painter->setBrush(QColor::fromHsv((page * 37) % 360, 160, 220));
+    painter->drawRect(QRectF(40, 760, 200, 120));
+    painter->drawEllipse(QRectF(280, 760, 160, 120));
+}
+
+// 清空进程的峰值内存记录，使每个用例单独统计（需要 Linux 4.0 及以上）
+static void resetPeakMemory()
+{
+    QFile clearRefs(QStringLiteral("/proc/self/clear_refs"));
+    if (clearRefs.open(QIODevice::WriteOnly))
+        clearRefs.write("5");
+}
+
+// 读取进程的峰值常驻内存，单位KB
+static qint64 peakMemory()
+{
+    QFile status(QStringLiteral("/proc/self/status"));
+    if (!status.open(QIODevice::ReadOnly))
+        return -1;
+
+    const QList<QByteArray> lines = status.readAll().split('\n');
+    for (const QByteArray &line : lines) {
+        if (line.startsWith("VmHWM:"))
+            return line.mid(6).trimmed().split(' ').first().toLongLong();
+    }
+
+    return -1;
+}
+
+class PrintPreviewBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void firstPage_data();
+    void firstPage();
+};
+
+void PrintPreviewBenchmark::firstPage_data()
+{
+    QTest::addColumn<int>("pageCount");
+    QTest::addColumn<PreviewMode>("mode");
+    QTest::addColumn<bool>("asynPreview");
+
+    const QList<QPair<const char *, PreviewMode>> modes = {
+        {"color", ColorMode},
+        {"grayscale", GrayscaleMode},
+        {"watermark", WaterMarkMode},
+        {"numberup", NumberUpMode},
+    };
+
+    for (int pageCount : {10, 100, 1000}) {
+        for (const auto &mode : modes) {
+            QTest::addRow("%s-%d", mode.first, pageCount) << pageCount << mode.second << false;
+            QTest::addRow("%s-%d-asyn", mode.first, pageCount) << pageCount << mode.second << true;
+        }
+    }
+}
+
+// 从创建预览控件到第一页绘制完成的耗时
+void PrintPreviewBenchmark::firstPage()
+{
+    QFETCH(int, pageCount);
+    QFETCH(PreviewMode, mode);
+    QFETCH(bool, asynPreview);
+
+    resetPeakMemory();
+
+    QBENCHMARK {
+        DPrinter printer;
+        DPrintPreviewWidget widget(&printer);
+        widget.resize(800, 600);
+
+        if (asynPreview) {
+            QObject::connect(&widget, QOverload<DPrinter *, const QVector<int> &>::of(&DPrintPreviewWidget::paintRequested),
+                             [](DPrinter *p, const QVector<int> &pages) {
+                QPainter painter(p);
+                for (int i = 0; i < pages.count(); ++i) {
+                    if (i != 0)
+                        p->newPage();
+                    drawSyntheticPage(&painter, pages.at(i));
+                }
+            });
+            widget.setAsynPreview(pageCount);
+        } else {
+            QObject::connect(&widget, QOverload<DPrinter *>::of(&DPrintPreviewWidget::paintRequested),
+                             [pageCount](DPrinter *p) {
+                QPainter painter(p);
+                for (int page = 1; page <= pageCount; ++page) {
+                    if (page != 1)
+                        p->newPage();
+                    drawSyntheticPage(&painter, page);
+                }
+            });
+        }
+
+        if (mode == GrayscaleMode)
+            widget.setColorMode(DPrinter::GrayScale);
+
+        widget.updatePreview();
+        QCoreApplication::processEvents();
+
+        if (mode == WaterMarkMode) {
+            widget.setWaterMarkType(1);
+            widget.setTextWaterMark(QStringLiteral("CONFIDENTIAL"));
+            widget.setWaterMarkLayout(1);
+        } else if (mode == NumberUpMode) {
+            widget.setImposition(DPrintPreviewWidget::FourRowFourCol);
+        }
+
+        // 强制绘制当前页
+        const QPixmap &firstPage = widget.grab();
+        QVERIFY(!firstPage.isNull());
+    }
+
+    qInfo("peak memory: %lld KB", peakMemory());
+}
+
+int main(int argc, char *argv[])
+{
+    // CI 上没有显示器和打印机，使用 offscreen 平台插件
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+    DApplication app(argc, argv);
+
+    PrintPreviewBenchmark benchmark;
+    return QTest::qExec(&benchmark, argc, argv);
+}
+
+#include "bench_dprintpreviewwidget.moc"
@@ -1278,7 +1278,7 @@ TEST_F(ut_DPrintPreviewWidgetPrivate, testPageItem)
     ASSERT_TRUE(testPixmapHasData(pixmap));
 
     content->updateGrayContent();
-    ASSERT_TRUE(content->grayPicture.size() > 0);
+    ASSERT_FALSE(content->grayscaleImage().isNull());
 
     // 非并打测试绘制函数
     pixmap.fill(Qt::gray);
@@ -1292,8 +1292,8 @@ TEST_F(ut_DPrintPreviewWidgetPrivate, testPageItem)
     ASSERT_TRUE(testPixmapHasData(pixmap));
 
     // 测试灰度转换是否正常
-    QPicture pic = content->grayscalePaint(*pview_d->pictures.first());
-    ASSERT_TRUE(pic.size() > 0);
+    QImage pic = content->grayscalePaint(*pview_d->pictures.first());
+    ASSERT_FALSE(pic.isNull());
     QImage origin(QSize(40, 40), QImage::Format_ARGB32);
     origin.fill(Qt::yellow);
 
@@ -4,6 +4,10 @@
 
 #include <gtest/gtest.h>
 
+#include <QSignalSpy>
+#include <QStringListModel>
+#include <QTest>
+
 #include "dlistview.h"
 DWIDGET_USE_NAMESPACE
 class ut_DListView : public testing::Test
@@ -170,6 +174,112 @@ TEST_F(ut_DListView, takeHeaderWidget)
     widget2->deleteLater();
 };
 
+TEST_F(ut_DListView, addItemsIncrementally)
+{
+    QSignalSpy progressSpy(target, &DListView::populationProgress);
+    QSignalSpy finishedSpy(target, &DListView::populationFinished);
+
+    QVariantList datas;
+    for (int i = 0; i < 100000; ++i)
+        datas << i;
+
+    target->setPopulationTimeBudget(1);
+    target->addItem(-1);
+    target->addItemsIncrementally(datas);
+    // 第一个时间片同步执行
+    ASSERT_GT(target->count(), 1);
+    ASSERT_EQ(progressSpy.count(), 1);
+
+    ASSERT_TRUE(QTest::qWaitFor([this] { return !target->isPopulating(); }, 10000));
+    ASSERT_EQ(finishedSpy.count(), 1);
+    ASSERT_EQ(progressSpy.last().at(0).toInt(), datas.count());
+    ASSERT_EQ(progressSpy.last().at(1).toInt(), datas.count());
+    ASSERT_EQ(target->count(), datas.count() + 1);
+    ASSERT_EQ(target->model()->index(0, 0).data().toInt(), -1);
+    ASSERT_EQ(target->model()->index(datas.count(), 0).data().toInt(), datas.count() - 1);
+};
+
+TEST_F(ut_DListView, cancelPopulation)
+{
+    QSignalSpy finishedSpy(target, &DListView::populationFinished);
+
+    QVariantList datas;
+    for (int i = 0; i < 100000; ++i)
+        datas << i;
+
+    target->setPopulationTimeBudget(1);
+    target->insertItemsIncrementally(0, datas);
+    target->cancelPopulation();
+    ASSERT_FALSE(target->isPopulating());
+
+    const int count = target->count();
+    QTest::qWait(10);
+    ASSERT_EQ(target->count(), count);
+    ASSERT_EQ(finishedSpy.count(), 0);
+};
+
+class LazyStringListModel : public QStringListModel
+{
+public:
+    using QStringListModel::QStringListModel;
+
+    bool canFetchMore(const QModelIndex &parent) const override
+    {
+        return !parent.isValid() && rowCount() < 1000;
+    }
+
+    void fetchMore(const QModelIndex &parent) override
+    {
+        const int row = rowCount(parent);
+        insertRows(row, 10, parent);
+    }
+};
+
+TEST_F(ut_DListView, fetchMoreIncrementally)
+{
+    LazyStringListModel model;
+    target->setModel(&model);
+
+    QSignalSpy progressSpy(target, &DListView::populationProgress);
+    QSignalSpy finishedSpy(target, &DListView::populationFinished);
+
+    target->fetchMoreIncrementally();
+    ASSERT_TRUE(QTest::qWaitFor([this] { return !target->isPopulating(); }, 10000));
+    ASSERT_EQ(model.rowCount(), 1000);
+    ASSERT_EQ(finishedSpy.count(), 1);
+    ASSERT_EQ(progressSpy.last().at(0).toInt(), 1000);
+
+    target->setModel(nullptr);
+};
+
+class ReadOnlyStringListModel : public QStringListModel
+{
+public:
+    using QStringListModel::QStringListModel;
+
+    bool insertRows(int, int, const QModelIndex &) override
+    {
+        return false;
+    }
+};
+
+TEST_F(ut_DListView, populationFailed)
+{
+    ReadOnlyStringListModel model;
+    target->setModel(&model);
+
+    QSignalSpy finishedSpy(target, &DListView::populationFinished);
+    QSignalSpy failedSpy(target, &DListView::populationFailed);
+
+    target->addItemsIncrementally(QVariantList {1, 2, 3});
+    ASSERT_FALSE(target->isPopulating());
+    ASSERT_EQ(failedSpy.count(), 1);
+    ASSERT_EQ(failedSpy.last().at(0).toInt(), 0);
+    ASSERT_EQ(finishedSpy.count(), 0);
+
+    target->setModel(nullptr);
+};
+
 class ut_DVariantListModel : public testing::Test
 {
 protected:
@@ -206,3 +316,43 @@ TEST_F(ut_DVariantListModel, setData)
     target->setData(target->index(0, 0), 1, Qt::DisplayRole);
     ASSERT_EQ(target->data(target->index(0, 0)).toInt(), 1);
 };
+
+TEST_F(ut_DVariantListModel, insertItems)
+{
+    int insertedCount = 0;
+    int changedCount = 0;
+    QObject::connect(target, &QAbstractItemModel::rowsInserted, [&insertedCount]() { ++insertedCount; });
+    QObject::connect(target, &QAbstractItemModel::dataChanged, [&changedCount]() { ++changedCount; });
+
+    ASSERT_TRUE(target->insertItems(0, QVariantList {1, 2, 5}));
+    ASSERT_TRUE(target->insertItems(2, QVariantList {3, 4}));
+    ASSERT_FALSE(target->insertItems(10, QVariantList {6}));
+    ASSERT_EQ(target->rowCount(), 5);
+    for (int i = 0; i < 5; ++i)
+        ASSERT_EQ(target->data(target->index(i, 0)).toInt(), i + 1);
+
+    ASSERT_EQ(insertedCount, 2);
+    ASSERT_EQ(changedCount, 0);
+};
+
+TEST_F(ut_DVariantListModel, replaceItems)
+{
+    int changedCount = 0;
+    target->insertItems(0, QVariantList {0, 0, 0, 0});
+    QObject::connect(target, &QAbstractItemModel::dataChanged, [&changedCount]() { ++changedCount; });
+
+    ASSERT_TRUE(target->replaceItems(1, QVariantList {1, 2}));
+    ASSERT_FALSE(target->replaceItems(3, QVariantList {1, 2}));
+    ASSERT_EQ(target->data(target->index(1, 0)).toInt(), 1);
+    ASSERT_EQ(target->data(target->index(2, 0)).toInt(), 2);
+    ASSERT_EQ(changedCount, 1);
+};
+
+TEST_F(ut_DVariantListModel, removeRangeRows)
+{
+    target->insertItems(0, QVariantList {1, 2, 3, 4, 5});
+    ASSERT_TRUE(target->removeRows(1, 3));
+    ASSERT_EQ(target->rowCount(), 2);
+    ASSERT_EQ(target->data(target->index(0, 0)).toInt(), 1);
+    ASSERT_EQ(target->data(target->index(1, 0)).toInt(), 5);
+};
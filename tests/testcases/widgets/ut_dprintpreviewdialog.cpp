@@ -5,6 +5,10 @@
 #include <gtest/gtest.h>
 
 #include "dprintpreviewdialog.h"
+#include "private/dprintpreviewdialog_p.h"
+
+#include <QCoreApplication>
+#include <QTest>
 DWIDGET_USE_NAMESPACE
 class ut_DPrintPreviewDialog : public testing::Test
 {
@@ -43,12 +47,48 @@ TEST_F(ut_DPrintPreviewDialog, printFromPath)
     target->printFromPath();
 };
 
+TEST_F(ut_DPrintPreviewDialog, printJobFailed)
+{
+    QString failedError;
+    QObject::connect(target, &DPrintPreviewDialog::printJobFailed, [&](const QString &error) {
+        failedError = error;
+    });
+
+    // 对话框转发预览控件提交打印任务的结果
+    auto *d = target->d_func();
+    d->pview->setPrintMode(DPrintPreviewWidget::PrintToPrinter);
+    d->pview->setPrintFromPath(QStringLiteral("/dtk-print-preview-nonexistent-file.pdf"));
+    d->pview->print();
+    ASSERT_TRUE(QTest::qWaitFor([&] { return !failedError.isEmpty(); }, 30000));
+};
+
 TEST_F(ut_DPrintPreviewDialog, setAsynPreview)
 {
     //target->setAsynPreview(1);
     //ASSERT_EQ(target->asynPreview(), 1);
 };
 
+TEST_F(ut_DPrintPreviewDialog, printerInfoCache)
+{
+    auto *d = target->d_func();
+    // 打印机信息在后台加载，加载完成前至少可以输出到PDF和图片
+    ASSERT_GE(d->printDeviceCombo->count(), 2);
+
+    if (d->printerInfoWatcher) {
+        d->printerInfoWatcher->waitForFinished();
+        QCoreApplication::processEvents();
+    }
+
+    ASSERT_FALSE(d->printerInfo.isExpired());
+    ASSERT_EQ(d->printDeviceCombo->count(), d->printerInfo.printerNames.count() + 2);
+
+    // 缓存有效期内再次打开对话框不会重新查询
+    DPrintPreviewDialog dialog;
+    auto *dd = dialog.d_func();
+    ASSERT_TRUE(!dd->printerInfoWatcher || !dd->printerInfoWatcher->isRunning());
+    ASSERT_EQ(dd->printerInfo.printerNames, d->printerInfo.printerNames);
+};
+
 TEST_F(ut_DPrintPreviewDialog, setDocName)
 {
     target->setDocName("setDocName");
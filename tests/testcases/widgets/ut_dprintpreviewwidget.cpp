@@ -4,7 +4,18 @@
 
 #include <gtest/gtest.h>
 
+#include <QPainter>
+#include <QTest>
+#include <QTemporaryDir>
+#include <QDir>
+#include <QFile>
+#include <QEventLoop>
+#include <QTimer>
+#include <QStandardItemModel>
+#include <DListView>
+
 #include "dprintpreviewwidget.h"
+#include "private/dprintpreviewwidget_p.h"
 DWIDGET_USE_NAMESPACE
 class ut_DPrintPreviewWidget : public testing::Test
 {
@@ -23,6 +34,361 @@ protected:
     DPrintPreviewWidget *target = nullptr;
 };
 
+TEST(ut_DPrintPreviewPageCache, asynPreviewRequestsOnDemand)
+{
+    DPrinter printer;
+    DPrintPreviewWidget widget(&printer);
+    QVector<QVector<int>> requests;
+    QObject::connect(&widget, QOverload<DPrinter *, const QVector<int> &>::of(&DPrintPreviewWidget::paintRequested),
+                     [&requests](DPrinter *p, const QVector<int> &pages) {
+        requests.append(pages);
+        QPainter painter(p);
+        for (int i = 0; i < pages.count(); ++i) {
+            if (i != 0)
+                p->newPage();
+            painter.drawText(10, 10, QString::number(pages.at(i)));
+        }
+    });
+
+    widget.setAsynPreview(1000);
+    auto *d = widget.d_func();
+    d->generatePreview();
+    // 首次预览只请求当前页，与文档长度无关
+    ASSERT_EQ(requests.count(), 1);
+    ASSERT_EQ(requests.first(), QVector<int>{1});
+    ASSERT_EQ(d->pictures.count(), 1);
+
+    d->prefetchNeighbourPages();
+    ASSERT_EQ(requests.count(), 2);
+    ASSERT_EQ(requests.last(), QVector<int>{2});
+
+    // 已预取的页面直接从缓存中获取
+    widget.setCurrentPage(2);
+    ASSERT_EQ(requests.count(), 2);
+    ASSERT_EQ(d->pictures.count(), 1);
+
+    widget.setCurrentPage(5);
+    ASSERT_EQ(requests.count(), 3);
+    ASSERT_EQ(requests.last(), QVector<int>{5});
+
+    widget.setCurrentPage(1);
+    ASSERT_EQ(requests.count(), 3);
+
+    // 重新生成预览时缓存失效
+    d->generatePreview();
+    ASSERT_EQ(requests.count(), 4);
+    ASSERT_LE(d->pageCache.totalCost(), d->pageCache.maxCost());
+}
+
+TEST(ut_DPrintPreviewPageCache, printAsImageInOrder)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+
+    DPrinter printer;
+    printer.setOutputFileName(dir.filePath("page.png"));
+    DPrintPreviewWidget widget(&printer);
+    QObject::connect(&widget, QOverload<DPrinter *, const QVector<int> &>::of(&DPrintPreviewWidget::paintRequested),
+                     [](DPrinter *p, const QVector<int> &pages) {
+        QPainter painter(p);
+        for (int i = 0; i < pages.count(); ++i) {
+            if (i != 0)
+                p->newPage();
+            // 用不同宽度的色块区分页码
+            painter.fillRect(QRect(0, 0, pages.at(i) * 10, 10), Qt::black);
+        }
+    });
+
+    widget.setAsynPreview(12);
+    widget.d_func()->generatePreview();
+    widget.setPrintMode(DPrintPreviewWidget::PrintToImage);
+    widget.print(true);
+
+    // 并行光栅化后每个文件仍然对应正确的页码
+    for (int page = 1; page <= 12; ++page) {
+        QImage image(dir.filePath(QString("page(%1).png").arg(page)));
+        ASSERT_FALSE(image.isNull());
+        const QPoint origin = printer.pageLayout().paintRectPixels(printer.resolution()).topLeft();
+        ASSERT_EQ(image.pixelColor(origin + QPoint(page * 10 - 5, 5)), QColor(Qt::black));
+        ASSERT_EQ(image.pixelColor(origin + QPoint(page * 10 + 5, 5)), QColor(Qt::white));
+    }
+}
+
+TEST(ut_DPrintPreviewPageCache, waterMarkImageCache)
+{
+    DPrinter printer;
+    DPrintPreviewWidget widget(&printer);
+    QObject::connect(&widget, QOverload<DPrinter *, const QVector<int> &>::of(&DPrintPreviewWidget::paintRequested),
+                     [](DPrinter *p, const QVector<int> &pages) {
+        QPainter painter(p);
+        for (int i = 1; i < pages.count(); ++i)
+            p->newPage();
+    });
+
+    widget.setAsynPreview(3);
+    auto *d = widget.d_func();
+    d->generatePreview();
+    widget.setTextWaterMark("watermark");
+
+    // 参数不变时各页共享同一份水印图像
+    const QImage &first = d->generateWaterMarkImage();
+    ASSERT_FALSE(first.isNull());
+    ASSERT_EQ(d->generateWaterMarkImage().cacheKey(), first.cacheKey());
+
+    widget.setWaterMarkColor(Qt::red);
+    ASSERT_NE(d->generateWaterMarkImage().cacheKey(), first.cacheKey());
+}
+
+TEST(ut_DPrintPreviewPageCache, streamPdfExport)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString fileName = dir.filePath("export.pdf");
+
+    DPrinter printer;
+    printer.setOutputFormat(QPrinter::PdfFormat);
+    printer.setOutputFileName(fileName);
+    DPrintPreviewWidget widget(&printer);
+    int maxRequestPages = 0;
+    QObject::connect(&widget, QOverload<DPrinter *, const QVector<int> &>::of(&DPrintPreviewWidget::paintRequested),
+                     [&maxRequestPages](DPrinter *p, const QVector<int> &pages) {
+        maxRequestPages = qMax(maxRequestPages, pages.count());
+        QPainter painter(p);
+        for (int i = 0; i < pages.count(); ++i) {
+            if (i != 0)
+                p->newPage();
+            painter.drawText(10, 10, QString::number(pages.at(i)));
+        }
+    });
+    QVector<int> progress;
+    QObject::connect(&widget, &DPrintPreviewWidget::exportProgress, [&progress](int current, int total) {
+        ASSERT_EQ(total, 20);
+        progress.append(current);
+    });
+
+    widget.setAsynPreview(20);
+    widget.d_func()->generatePreview();
+    widget.setPrintMode(DPrintPreviewWidget::PrintToPdf);
+    widget.print();
+
+    // 导出过程中每次只请求部分页面
+    ASSERT_LE(maxRequestPages, PREVIEW_EXPORT_CHUNK_PAGES);
+    ASSERT_EQ(progress.last(), 20);
+    ASSERT_TRUE(QFile::exists(fileName));
+
+    // 取消导出后删除未完成的文件
+    QFile::remove(fileName);
+    progress.clear();
+    auto cancelConnection = QObject::connect(&widget, &DPrintPreviewWidget::exportProgress, &widget, &DPrintPreviewWidget::cancelExport);
+    widget.print();
+    ASSERT_EQ(progress.count(), 1);
+    ASSERT_FALSE(QFile::exists(fileName));
+    QObject::disconnect(cancelConnection);
+
+    // 导出期间的事件在每一批之间处理，再次打印的请求被忽略
+    progress.clear();
+    QTimer::singleShot(0, &widget, [&widget] { widget.print(); });
+    widget.print();
+    ASSERT_EQ(progress.count(), (20 + PREVIEW_EXPORT_CHUNK_PAGES - 1) / PREVIEW_EXPORT_CHUNK_PAGES);
+    ASSERT_EQ(progress.last(), 20);
+    ASSERT_TRUE(QFile::exists(fileName));
+
+    // 取消按钮等导出期间投递的事件可以取消导出
+    QFile::remove(fileName);
+    progress.clear();
+    QTimer::singleShot(0, &widget, &DPrintPreviewWidget::cancelExport);
+    widget.print();
+    ASSERT_EQ(progress.count(), 1);
+    ASSERT_FALSE(QFile::exists(fileName));
+}
+
+TEST(ut_DPrintPreviewPageCache, thumbnailBar)
+{
+    DPrinter printer;
+    DPrintPreviewWidget widget(&printer);
+    int requestedPages = 0;
+    QObject::connect(&widget, QOverload<DPrinter *, const QVector<int> &>::of(&DPrintPreviewWidget::paintRequested),
+                     [&requestedPages](DPrinter *p, const QVector<int> &pages) {
+        requestedPages += pages.count();
+        QPainter painter(p);
+        for (int i = 0; i < pages.count(); ++i) {
+            if (i != 0)
+                p->newPage();
+            painter.fillRect(QRect(0, 0, 100, 100), Qt::black);
+        }
+    });
+
+    ASSERT_FALSE(widget.isThumbnailBarVisible());
+    widget.setAsynPreview(30);
+    widget.setThumbnailBarVisible(true);
+    ASSERT_TRUE(widget.isThumbnailBarVisible());
+
+    auto *d = widget.d_func();
+    d->generatePreview();
+    ASSERT_EQ(d->thumbnailModel->rowCount(), 30);
+
+    // 布局后只有视口内的几个缩略图可见
+    widget.resize(800, 600);
+    widget.show();
+    ASSERT_TRUE(QTest::qWaitForWindowExposed(&widget));
+
+    for (int i = 0; i < 100 && d->nextThumbnailRow() >= 0; ++i) {
+        d->renderNextThumbnail();
+        d->thumbnailWatcher->waitForFinished();
+        QCoreApplication::processEvents();
+    }
+
+    // 可见的缩略图已生成，不可见且未缓存的页面不会单独请求数据
+    ASSERT_TRUE(d->thumbnailModel->item(0)->data(Qt::UserRole).toBool());
+    ASSERT_LT(requestedPages, 30);
+
+    widget.setCurrentPage(5);
+    ASSERT_EQ(d->thumbnailView->currentIndex().row(), 4);
+
+    widget.setThumbnailBarVisible(false);
+    ASSERT_FALSE(widget.isThumbnailBarVisible());
+}
+
+TEST(ut_DPrintPreviewPageCache, printByCupsAsync)
+{
+    DPrinter printer;
+    DPrintPreviewWidget widget(&printer);
+    widget.setPrintMode(DPrintPreviewWidget::PrintToPrinter);
+    widget.setPrintFromPath(QStringLiteral("/dtk-print-preview-nonexistent-file.pdf"));
+
+    int submittedJob = 0;
+    QString failedError;
+    QEventLoop loop;
+    QObject::connect(&widget, &DPrintPreviewWidget::printJobSubmitted, &loop, [&](int jobId) {
+        submittedJob = jobId;
+        loop.quit();
+    });
+    QObject::connect(&widget, &DPrintPreviewWidget::printJobFailed, &loop, [&](const QString &error) {
+        failedError = error;
+        loop.quit();
+    });
+    QTimer::singleShot(30000, &loop, &QEventLoop::quit);
+
+    // 提交任务在工作线程中进行，print 会立即返回，结果通过信号通知
+    widget.print();
+    loop.exec();
+
+    ASSERT_EQ(submittedJob, 0);
+    ASSERT_FALSE(failedError.isEmpty());
+}
+
+TEST(ut_DPrintPreviewPageCache, printByCupsCopiesFile)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString path = dir.filePath(QStringLiteral("print.txt"));
+    QFile file(path);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.write("dtk print preview");
+    file.close();
+
+    const QStringList copyFilter = {QStringLiteral("dtk-print-*")};
+    const QStringList copies = QDir::temp().entryList(copyFilter, QDir::Files);
+
+    DPrinter printer;
+    auto widget = new DPrintPreviewWidget(&printer);
+    widget->setPrintMode(DPrintPreviewWidget::PrintToPrinter);
+    widget->setPrintFromPath(path);
+
+    bool finished = false;
+    QObject::connect(widget, &DPrintPreviewWidget::printJobSubmitted, [&] { finished = true; });
+    QObject::connect(widget, &DPrintPreviewWidget::printJobFailed, [&] { finished = true; });
+
+    // print 返回后即可删除源文件，任务提交的是副本
+    widget->print();
+    ASSERT_TRUE(QFile::remove(path));
+    ASSERT_TRUE(QTest::qWaitFor([&] { return finished; }, 30000));
+
+    // 副本在提交后被删除，控件销毁不影响正在提交的任务
+    widget->print();
+    delete widget;
+    ASSERT_TRUE(QTest::qWaitFor([&] { return QDir::temp().entryList(copyFilter, QDir::Files) == copies; }, 30000));
+}
+
+TEST(ut_DPrintPreviewPageCache, numberUpSheetCache)
+{
+    DPrinter printer;
+    DPrintPreviewWidget widget(&printer);
+    QObject::connect(&widget, QOverload<DPrinter *, const QVector<int> &>::of(&DPrintPreviewWidget::paintRequested),
+                     [](DPrinter *p, const QVector<int> &pages) {
+        QPainter painter(p);
+        for (int i = 0; i < pages.count(); ++i) {
+            if (i != 0)
+                p->newPage();
+            painter.drawText(10, 10, QString::number(pages.at(i)));
+        }
+    });
+
+    widget.setAsynPreview(64);
+    widget.setImposition(DPrintPreviewWidget::FourRowFourCol);
+    auto *d = widget.d_func();
+    PageItem *pageItem = dynamic_cast<PageItem *>(d->pages.first());
+    ASSERT_TRUE(pageItem);
+
+    QImage image(QSize(200, 200), QImage::Format_ARGB32_Premultiplied);
+    auto drawSheet = [&] {
+        QPainter painter(&image);
+        pageItem->content->drawNumberUpPictures(&painter);
+    };
+
+    drawSheet();
+    ASSERT_EQ(d->numberUpSheetCache.count(), 1);
+    // 重复绘制同一页时直接使用缓存的拼版页面
+    drawSheet();
+    ASSERT_EQ(d->numberUpSheetCache.count(), 1);
+
+    widget.setCurrentPage(2);
+    drawSheet();
+    ASSERT_EQ(d->numberUpSheetCache.count(), 2);
+
+    widget.setCurrentPage(1);
+    drawSheet();
+    ASSERT_EQ(d->numberUpSheetCache.count(), 2);
+
+    // 水印设置不影响拼版结果
+    widget.setTextWaterMark(QStringLiteral("watermark"));
+    drawSheet();
+    ASSERT_EQ(d->numberUpSheetCache.count(), 2);
+
+    // 放大后拼版页面超出缓存上限，直接回放页面数据而不分配整页图像
+    {
+        QPainter painter(&image);
+        painter.scale(20, 20);
+        pageItem->content->drawNumberUpPictures(&painter);
+    }
+    ASSERT_EQ(d->numberUpSheetCache.count(), 2);
+
+    // 页面内容重新生成后缓存失效
+    d->generatePreview();
+    ASSERT_EQ(d->numberUpSheetCache.count(), 0);
+}
+
+TEST(ut_DPrintPreviewPageCache, imageGrayscale)
+{
+    ContentItem content(nullptr, QRect(0, 0, 64, 48));
+    QImage origin(QSize(64, 48), QImage::Format_ARGB32);
+    for (int y = 0; y < origin.height(); ++y) {
+        for (int x = 0; x < origin.width(); ++x)
+            origin.setPixel(x, y, qRgba(x * 4, y * 5, (x + y) * 2, (x * y) % 256));
+    }
+
+    // 逐行转换的结果需要与 qGray 逐像素计算一致，且保留透明度
+    const QImage &gray = content.imageGrayscale(&origin);
+    ASSERT_EQ(gray.size(), origin.size());
+    for (int y = 0; y < origin.height(); ++y) {
+        for (int x = 0; x < origin.width(); ++x) {
+            const QRgb pixel = origin.pixel(x, y);
+            const int value = qGray(pixel);
+            ASSERT_EQ(gray.pixel(x, y), qRgba(value, value, value, qAlpha(pixel)));
+        }
+    }
+}
+
 //TEST_F(ut_DPrintPreviewWidget, currentPage)
 //{
 //    target->currentPage();
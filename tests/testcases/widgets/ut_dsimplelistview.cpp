@@ -206,3 +206,383 @@ TEST_F(ut_DSimpleListView, testDSimpleListViewSelectPrev)
     listView->selectPrevItem();
     widget->show();
 }
+
+class CountingListItem : public DSimpleListItem {
+public:
+    int backgroundCount = 0;
+    int foregroundCount = 0;
+
+    bool sameAs(DSimpleListItem *item) override {
+        return item == this;
+    }
+
+    void drawBackground(QRect rect, QPainter *painter, int index, bool isSelect, bool isHover) override {
+        Q_UNUSED(rect)
+        Q_UNUSED(painter)
+        Q_UNUSED(index)
+        Q_UNUSED(isSelect)
+        Q_UNUSED(isHover)
+        ++backgroundCount;
+    }
+
+    void drawForeground(QRect rect, QPainter *painter, int column, int index, bool isSelect, bool isHover) override {
+        Q_UNUSED(rect)
+        Q_UNUSED(painter)
+        Q_UNUSED(column)
+        Q_UNUSED(index)
+        Q_UNUSED(isSelect)
+        Q_UNUSED(isHover)
+        ++foregroundCount;
+    }
+};
+
+TEST_F(ut_DSimpleListView, paintVisibleRowsOnly)
+{
+    // 绘制的行数只与可见区域有关，与总行数无关
+    for (int rowCount : {1000, 1000000}) {
+        CountingListItem item;
+        DSimpleListView view;
+        view.resize(300, 200);
+        view.setRowHeight(20);
+
+        QList<DSimpleListItem *> itemList;
+        itemList.reserve(rowCount);
+        for (int i = 0; i < rowCount; ++i)
+            itemList << &item;
+        view.addItems(itemList);
+
+        QImage image(view.size(), QImage::Format_ARGB32_Premultiplied);
+        view.render(&image);
+        ASSERT_EQ(item.backgroundCount, 10);
+
+        item.backgroundCount = 0;
+        view.ctrlScrollToEnd();
+        view.render(&image);
+        ASSERT_EQ(item.backgroundCount, 10);
+    }
+}
+
+TEST_F(ut_DSimpleListView, rowHitTest)
+{
+    QList<DSimpleListItem *> itemList;
+    for (int i = 0; i < 1000; ++i)
+        itemList << new CountingListItem;
+
+    listView->setRowHeight(20);
+    listView->addItems(itemList);
+    listView->ctrlScrollToEnd();
+
+    QTest::mouseClick(listView, Qt::LeftButton, Qt::NoModifier, QPoint(10, 5));
+    ASSERT_EQ(listView->getSelections().size(), 1);
+    ASSERT_EQ(listView->getSelections().first(), itemList.at(990));
+
+    listView->shiftSelectToHome();
+    ASSERT_EQ(listView->getSelections().size(), 991);
+
+    listView->clearItems();
+}
+
+class KeyedListItem : public CountingListItem {
+public:
+    static int sameAsCount;
+    quint64 key = 0;
+    quint64 version = 1;
+
+    explicit KeyedListItem(quint64 k) : key(k) {}
+
+    bool sameAs(DSimpleListItem *item) override {
+        ++sameAsCount;
+        return static_cast<KeyedListItem *>(item)->key == key;
+    }
+
+    quint64 identityKey() const override {
+        return key;
+    }
+
+    quint64 contentVersion() const override {
+        return version;
+    }
+};
+
+int KeyedListItem::sameAsCount = 0;
+
+TEST_F(ut_DSimpleListView, refreshItemsWithIdentityKey)
+{
+    auto createItems = [] {
+        QList<DSimpleListItem *> itemList;
+        for (int i = 1; i <= 1000; ++i)
+            itemList << new KeyedListItem(i);
+        return itemList;
+    };
+
+    listView->addItems(createItems());
+    listView->selectLastItem();
+    listView->shiftSelectPageUp();
+    const int selectionCount = listView->getSelections().size();
+    ASSERT_GT(selectionCount, 1);
+
+    KeyedListItem::sameAsCount = 0;
+    const QList<DSimpleListItem *> newItems = createItems();
+    listView->refreshItems(newItems);
+
+    // 有标识的列表项通过哈希恢复选中状态，不再调用 sameAs
+    ASSERT_EQ(KeyedListItem::sameAsCount, 0);
+    ASSERT_EQ(listView->getSelections().size(), selectionCount);
+    for (DSimpleListItem *item : listView->getSelections())
+        ASSERT_TRUE(newItems.contains(item));
+    ASSERT_TRUE(listView->getSelections().contains(newItems.last()));
+
+    listView->clearItems();
+}
+
+static bool keySearch(const DSimpleListItem *item, QString content)
+{
+    return QString::number(static_cast<const KeyedListItem *>(item)->key).contains(content);
+}
+
+TEST_F(ut_DSimpleListView, backgroundSearch)
+{
+    const int itemCount = 20000;
+    QList<DSimpleListItem *> itemList;
+    for (int i = 1; i <= itemCount; ++i)
+        itemList << new KeyedListItem(i);
+
+    auto expectedCount = [itemCount](const QString &content) {
+        int count = 0;
+        for (int i = 1; i <= itemCount; ++i)
+            count += QString::number(i).contains(content) ? 1 : 0;
+        return count;
+    };
+    auto searchResultCount = [this] {
+        listView->selectAllItems();
+        return listView->getSelections().size();
+    };
+
+    listView->setSearchAlgorithm(keySearch);
+    listView->setIncrementalSearch(true);
+    listView->addItems(itemList);
+
+    // 默认在界面线程中搜索
+    listView->search("3");
+    ASSERT_FALSE(listView->isSearching());
+    ASSERT_EQ(searchResultCount(), expectedCount("3"));
+
+    listView->setBackgroundSearch(true);
+    listView->search("1");
+    ASSERT_TRUE(QTest::qWaitFor([this] { return !listView->isSearching(); }, 5000));
+    ASSERT_EQ(searchResultCount(), expectedCount("1"));
+
+    // 在上次结果的基础上继续过滤
+    listView->search("12");
+    ASSERT_TRUE(QTest::qWaitFor([this] { return !listView->isSearching(); }, 5000));
+    ASSERT_EQ(searchResultCount(), expectedCount("12"));
+
+    // 新的搜索取代未完成的搜索
+    listView->search("2");
+    listView->search("23");
+    ASSERT_TRUE(QTest::qWaitFor([this] { return !listView->isSearching(); }, 5000));
+    ASSERT_EQ(searchResultCount(), expectedCount("23"));
+
+    listView->search("");
+    ASSERT_FALSE(listView->isSearching());
+    ASSERT_EQ(searchResultCount(), itemCount);
+
+    listView->clearSelections();
+    listView->clearItems();
+}
+
+static bool bucketSort(const DSimpleListItem *item1, const DSimpleListItem *item2, bool descendingSort)
+{
+    const quint64 bucket1 = static_cast<const KeyedListItem *>(item1)->key / 10;
+    const quint64 bucket2 = static_cast<const KeyedListItem *>(item2)->key / 10;
+
+    return descendingSort ? bucket1 > bucket2 : bucket1 < bucket2;
+}
+
+TEST_F(ut_DSimpleListView, incrementalAndStableSort)
+{
+    auto createItems = [](int from, int to) {
+        QList<DSimpleListItem *> itemList;
+        for (int i = to; i >= from; --i)
+            itemList << new KeyedListItem(i);
+        return itemList;
+    };
+    auto renderKeys = [this] {
+        QList<quint64> keys;
+        listView->selectAllItems();
+        for (DSimpleListItem *item : listView->getSelections())
+            keys << static_cast<KeyedListItem *>(item)->key;
+        listView->clearSelections();
+        return keys;
+    };
+    auto isSorted = [](const QList<quint64> &keys) {
+        for (int i = 1; i < keys.count(); ++i) {
+            if (keys.at(i - 1) / 10 > keys.at(i) / 10)
+                return false;
+        }
+        return true;
+    };
+
+    listView->setColumnTitleInfo({"key"}, {100}, 0);
+    listView->setColumnSortingAlgorithms(new QList<SortAlgorithm>{bucketSort}, 0, false);
+    listView->setStableSort(true);
+
+    listView->addItems(createItems(1, 30000));
+    QList<quint64> keys = renderKeys();
+    ASSERT_EQ(keys.count(), 30000);
+    ASSERT_TRUE(isSorted(keys));
+
+    // 新增的列表项归并到已排序的列表中
+    listView->addItems(createItems(30001, 35000));
+    keys = renderKeys();
+    ASSERT_EQ(keys.count(), 35000);
+    ASSERT_TRUE(isSorted(keys));
+
+    // 刷新后相等的列表项保持上次的相对顺序
+    QList<DSimpleListItem *> newItems = createItems(1, 35000);
+    std::reverse(newItems.begin(), newItems.end());
+    listView->refreshItems(newItems);
+    ASSERT_EQ(renderKeys(), keys);
+
+    // 并行排序的结果与串行排序一致
+    listView->setParallelSort(true);
+    newItems = createItems(1, 35000);
+    std::reverse(newItems.begin(), newItems.end());
+    listView->refreshItems(newItems);
+    ASSERT_EQ(renderKeys(), keys);
+
+    listView->clearItems();
+}
+
+static int versionSortCount = 0;
+
+static bool versionSort(const DSimpleListItem *item1, const DSimpleListItem *item2, bool descendingSort)
+{
+    ++versionSortCount;
+    const quint64 version1 = static_cast<const KeyedListItem *>(item1)->version;
+    const quint64 version2 = static_cast<const KeyedListItem *>(item2)->version;
+
+    return descendingSort ? version1 > version2 : version1 < version2;
+}
+
+TEST_F(ut_DSimpleListView, refreshKeepsSortedOrder)
+{
+    const int itemCount = 20000;
+    auto createItems = [itemCount](const QHash<int, quint64> &changedVersions = {}) {
+        QList<DSimpleListItem *> itemList;
+        for (int i = itemCount; i >= 1; --i) {
+            auto item = new KeyedListItem(i);
+            item->version = changedVersions.value(i, i);
+            itemList << item;
+        }
+        return itemList;
+    };
+    auto renderVersions = [this] {
+        QList<quint64> versions;
+        listView->selectAllItems();
+        for (DSimpleListItem *item : listView->getSelections())
+            versions << static_cast<KeyedListItem *>(item)->version;
+        listView->clearSelections();
+        return versions;
+    };
+
+    listView->setColumnTitleInfo({"version"}, {100}, 0);
+    listView->setColumnSortingAlgorithms(new QList<SortAlgorithm>{versionSort}, 0, false);
+    listView->addItems(createItems());
+
+    // 排序键不变时刷新只需线性次数的比较
+    versionSortCount = 0;
+    listView->refreshItems(createItems());
+    ASSERT_LT(versionSortCount, 2 * itemCount);
+    QList<quint64> versions = renderVersions();
+    ASSERT_EQ(versions.count(), itemCount);
+    ASSERT_TRUE(std::is_sorted(versions.begin(), versions.end()));
+
+    // 少量列表项变化时只排序变化的列表项，再与其余列表项归并
+    versionSortCount = 0;
+    listView->refreshItems(createItems({{1, 15000}, {9000, 3}, {20000, 0}}));
+    ASSERT_LT(versionSortCount, 6 * itemCount);
+    versions = renderVersions();
+    ASSERT_EQ(versions.count(), itemCount);
+    ASSERT_TRUE(std::is_sorted(versions.begin(), versions.end()));
+    ASSERT_EQ(versions.first(), 0u);
+
+    listView->clearItems();
+}
+
+class PaintCounter : public QObject {
+public:
+    int count = 0;
+
+    bool eventFilter(QObject *watched, QEvent *event) override {
+        if (event->type() == QEvent::Paint)
+            ++count;
+        return QObject::eventFilter(watched, event);
+    }
+};
+
+TEST_F(ut_DSimpleListView, batchUpdate)
+{
+    PaintCounter counter;
+    listView->installEventFilter(&counter);
+    widget->show();
+    ASSERT_TRUE(QTest::qWaitForWindowExposed(widget));
+    QCoreApplication::processEvents();
+
+    QList<DSimpleListItem *> itemList;
+    for (int i = 1; i <= 100; ++i)
+        itemList << new KeyedListItem(i);
+
+    counter.count = 0;
+    listView->beginUpdate();
+    listView->addItems(itemList);
+    listView->selectFirstItem();
+    listView->selectNextItem();
+    listView->ctrlScrollToEnd();
+    QCoreApplication::processEvents();
+    ASSERT_EQ(counter.count, 0);
+
+    listView->endUpdate();
+    ASSERT_TRUE(QTest::qWaitFor([&counter] { return counter.count > 0; }, 1000));
+    ASSERT_EQ(counter.count, 1);
+
+    listView->removeEventFilter(&counter);
+    listView->clearItems();
+}
+
+TEST_F(ut_DSimpleListView, rowCache)
+{
+    QList<DSimpleListItem *> itemList;
+    for (int i = 1; i <= 100; ++i)
+        itemList << new KeyedListItem(i);
+
+    listView->setRowHeight(20);
+    listView->setRowCacheEnabled(true);
+    listView->addItems(itemList);
+
+    auto foregroundCount = [&itemList] {
+        int count = 0;
+        for (DSimpleListItem *item : itemList)
+            count += static_cast<KeyedListItem *>(item)->foregroundCount;
+        return count;
+    };
+
+    QImage image(listView->size(), QImage::Format_ARGB32_Premultiplied);
+    listView->render(&image);
+    ASSERT_EQ(foregroundCount(), 10);
+
+    // 内容没有变化时直接使用缓存
+    listView->render(&image);
+    ASSERT_EQ(foregroundCount(), 10);
+
+    // 内容版本变化的行重新绘制
+    static_cast<KeyedListItem *>(itemList.first())->version = 2;
+    listView->render(&image);
+    ASSERT_EQ(foregroundCount(), 11);
+
+    listView->setRowCacheEnabled(false);
+    listView->render(&image);
+    ASSERT_EQ(foregroundCount(), 21);
+
+    listView->clearItems();
+}
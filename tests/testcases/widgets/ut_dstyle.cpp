@@ -0,0 +1,52 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <QImage>
+#include <QPainter>
+#include <QWidget>
+
+#include "dstyle.h"
+DWIDGET_USE_NAMESPACE
+class ut_DStyle : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        target = new DStyle();
+        DStyle::resetPaintProfile();
+    }
+    void TearDown() override
+    {
+        DStyle::setPaintProfileEnabled(false);
+        DStyle::resetPaintProfile();
+        delete target;
+        target = nullptr;
+    }
+    DStyle *target = nullptr;
+};
+
+TEST_F(ut_DStyle, paintProfile)
+{
+    QImage image(20, 20, QImage::Format_ARGB32_Premultiplied);
+    QPainter painter(&image);
+    QWidget widget;
+    QStyleOption opt;
+    opt.initFrom(&widget);
+    opt.rect = image.rect();
+
+    DStyle::setPaintProfileEnabled(false);
+    target->drawPrimitive(QStyle::PE_IndicatorArrowUp, &opt, &painter, &widget);
+    ASSERT_FALSE(DStyle::paintProfileReport().contains("PE_IndicatorArrowUp"));
+
+    DStyle::setPaintProfileEnabled(true);
+    ASSERT_TRUE(DStyle::paintProfileEnabled());
+    target->drawPrimitive(QStyle::PE_IndicatorArrowUp, &opt, &painter, &widget);
+    const QString &report = DStyle::paintProfileReport();
+    ASSERT_TRUE(report.contains("PE_IndicatorArrowUp"));
+    ASSERT_TRUE(report.contains("QWidget"));
+
+    DStyle::resetPaintProfile();
+    ASSERT_FALSE(DStyle::paintProfileReport().contains("PE_IndicatorArrowUp"));
+};
@@ -6,6 +6,8 @@
 #include <gtest/gtest.h>
 #include <QListView>
 #include <QPointer>
+#include <QPainter>
+#include <QStandardItemModel>
 
 #include "dstyleditemdelegate.h"
 DWIDGET_USE_NAMESPACE
@@ -144,6 +146,161 @@ TEST_F(ut_DStyledItemDelegate, paint)
     model->deleteLater();
 };
 
+TEST_F(ut_DStyledItemDelegate, sizeHintCache)
+{
+    parent->setItemDelegate(target);
+    QStandardItemModel* model = new QStandardItemModel();
+    QStandardItem *item = new QStandardItem("text");
+    model->appendRow(item);
+    model->appendRow(new QStandardItem("text"));
+    parent->setModel(model);
+
+    QStyleOptionViewItem option;
+    option.initFrom(parent);
+    const QSize size = target->sizeHint(option, model->index(0, 0));
+    ASSERT_EQ(target->sizeHint(option, model->index(0, 0)), size);
+
+    // 数据变化后不能返回缓存的大小
+    QFont font = item->font();
+    font.setPixelSize(font.pixelSize() > 0 ? font.pixelSize() * 3 : 48);
+    item->setFont(font);
+    const QSize largeSize = target->sizeHint(option, model->index(0, 0));
+    ASSERT_GT(largeSize.height(), size.height());
+
+    // 插入到前面后行号对应的是新的项
+    model->insertRow(0, new QStandardItem("text"));
+    ASSERT_EQ(target->sizeHint(option, model->index(0, 0)), size);
+    ASSERT_EQ(target->sizeHint(option, model->index(1, 0)), largeSize);
+
+    // 统一大小时所有项使用第一次计算的结果
+    model->setProperty("_d_dtk_uniformItemSizes", true);
+    const QSize uniformSize = target->sizeHint(option, model->index(0, 0));
+    ASSERT_EQ(target->sizeHint(option, model->index(1, 0)), uniformSize);
+
+    parent->setModel(nullptr);
+    model->deleteLater();
+};
+
+class RoleCountingModel : public QStandardItemModel
+{
+public:
+    mutable int actionQueries = 0;
+
+    QVariant data(const QModelIndex &index, int role) const override
+    {
+        // 只有缓存未命中时 sizeHint 才会查询 action
+        if (role == Dtk::LeftActionListRole)
+            ++actionQueries;
+        return QStandardItemModel::data(index, role);
+    }
+};
+
+TEST_F(ut_DStyledItemDelegate, sizeHintCacheFollowsRows)
+{
+    parent->setItemDelegate(target);
+    RoleCountingModel *model = new RoleCountingModel();
+    for (int i = 1; i <= 100; ++i)
+        model->appendRow(new QStandardItem(QString(i, QLatin1Char('x'))));
+    parent->setModel(model);
+
+    QStyleOptionViewItem option;
+    option.initFrom(parent);
+    QHash<QString, QSize> sizes;
+    for (int row = 0; row < model->rowCount(); ++row) {
+        const QModelIndex &index = model->index(row, 0);
+        sizes.insert(index.data().toString(), target->sizeHint(option, index));
+    }
+
+    // 插入、删除和排序后缓存跟随各自的项，只有新的项需要重新计算
+    model->actionQueries = 0;
+    model->insertRow(0, new QStandardItem("new"));
+    model->removeRow(50);
+    model->sort(0, Qt::DescendingOrder);
+    for (int row = 0; row < model->rowCount(); ++row) {
+        const QModelIndex &index = model->index(row, 0);
+        const QSize &size = target->sizeHint(option, index);
+        if (sizes.contains(index.data().toString()))
+            ASSERT_EQ(size, sizes.value(index.data().toString()));
+    }
+    ASSERT_EQ(model->actionQueries, 1);
+
+    parent->setModel(nullptr);
+    delete model;
+};
+
+TEST_F(ut_DStyledItemDelegate, sizeHintActionChanged)
+{
+    parent->setItemDelegate(target);
+    QStandardItemModel* model = new QStandardItemModel();
+    DStandardItem *item = new DStandardItem("text");
+    DViewItemAction *action = new DViewItemAction(Qt::AlignVCenter);
+    action->setText("action");
+    item->setActionList(Qt::RightEdge, {action});
+    model->appendRow(item);
+    parent->setModel(model);
+
+    QStyleOptionViewItem option;
+    option.initFrom(parent);
+    const QModelIndex &index = model->index(0, 0);
+    const QSize size = target->sizeHint(option, index);
+
+    // action 的变化不会发出 dataChanged，缓存的大小也需要更新
+    action->setText("longer action text");
+    ASSERT_GT(target->sizeHint(option, index).width(), size.width());
+
+    action->setText("action");
+    ASSERT_EQ(target->sizeHint(option, index), size);
+
+    parent->setModel(nullptr);
+    delete model;
+};
+
+TEST_F(ut_DStyledItemDelegate, actionLayoutCache)
+{
+    parent->setItemDelegate(target);
+    QStandardItemModel* model = new QStandardItemModel();
+    DStandardItem *item = new DStandardItem("text");
+    DViewItemAction *action = new DViewItemAction(Qt::AlignVCenter);
+    action->setText("action");
+    item->setActionList(Qt::RightEdge, {action});
+    model->appendRow(item);
+    model->appendRow(new DStandardItem("text"));
+    parent->setModel(model);
+
+    QStyleOptionViewItem option;
+    option.initFrom(parent);
+    option.rect = QRect(0, 0, 200, 50);
+
+    auto render = [&](const QModelIndex &index) {
+        QImage image(option.rect.size(), QImage::Format_ARGB32_Premultiplied);
+        image.fill(Qt::transparent);
+        QPainter painter(&image);
+        target->paint(&painter, option, index);
+        return image;
+    };
+
+    const QModelIndex &index = model->index(0, 0);
+    const QImage &withAction = render(index);
+    const QImage &withoutAction = render(model->index(1, 0));
+    ASSERT_NE(withAction, withoutAction);
+
+    // 重绘使用缓存的布局，结果不变
+    ASSERT_EQ(render(index), withAction);
+
+    action->setText("longer action text");
+    ASSERT_NE(render(index), withAction);
+
+    action->setVisible(false);
+    ASSERT_EQ(render(index), withoutAction);
+
+    action->setVisible(true);
+    item->setActionList(Qt::RightEdge, {});
+    ASSERT_EQ(render(index), withoutAction);
+
+    parent->setModel(nullptr);
+    delete model;
+};
+
 class ut_DViewItemAction : public testing::Test
 {
 protected:
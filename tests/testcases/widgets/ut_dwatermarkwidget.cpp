@@ -5,8 +5,12 @@
 #include <gtest/gtest.h>
 #include <QLabel>
 #include <QTest>
+#include <QPainter>
+#include <QtMath>
 
 #include "dwatermarkwidget.h"
+#include "private/dwatermarkwidget_p.h"
+
 DWIDGET_USE_NAMESPACE
 class ut_DWaterMarkWidget : public testing::Test
 {
@@ -66,3 +70,97 @@ TEST_F(ut_DWaterMarkWidget, paintImage)
 
     EXPECT_TRUE(equalImage(QImage(":/data/watermarks/image.png")));
 }
+
+TEST_F(ut_DWaterMarkWidget, centerImageCache)
+{
+    WaterMarkData data = target->data();
+    data.setType(WaterMarkData::Image);
+    data.setImage(QImage(":/assets/images/uos.svg"));
+    data.setOpacity(0.8);
+    target->setData(data);
+
+    auto *d = target->d_func();
+    root->grab();
+    ASSERT_FALSE(d->centerImageCache.isNull());
+    const qint64 cacheKey = d->centerImageCache.cacheKey();
+
+    // 重复绘制时直接使用缓存的图片
+    root->grab();
+    ASSERT_EQ(d->centerImageCache.cacheKey(), cacheKey);
+
+    // 透明度或灰度变化时重新生成
+    data.setOpacity(0.5);
+    target->setData(data);
+    root->grab();
+    const qint64 opacityCacheKey = d->centerImageCache.cacheKey();
+    ASSERT_NE(opacityCacheKey, cacheKey);
+
+    data.setGrayScale(!data.grayScale());
+    target->setData(data);
+    root->grab();
+    ASSERT_NE(d->centerImageCache.cacheKey(), opacityCacheKey);
+}
+
+TEST_F(ut_DWaterMarkWidget, textureBrush)
+{
+    // 完全不透明的纹理按点阵排布后恰好铺满平面，接缝处缺少的纹理会留下透明区域
+    QImage texture(200, 60, QImage::Format_ARGB32_Premultiplied);
+    texture.fill(Qt::black);
+
+    for (qreal rotation : {0.0, 30.0, 45.0, 90.0, -15.0}) {
+        const QBrush &brush = DWaterMarkWidgetPrivate::createTextureBrush(texture, rotation);
+        const QImage &tile = brush.textureImage();
+        ASSERT_FALSE(tile.isNull()) << rotation;
+
+        const int majorSize = qMax(tile.width(), tile.height());
+        const int minorSize = qMin(tile.width(), tile.height());
+        ASSERT_LE(majorSize, WATERMARK_TILE_MAX_SIZE) << rotation;
+        ASSERT_LE(majorSize, WATERMARK_TILE_MAX_ROWS * texture.width()) << rotation;
+        ASSERT_LE(minorSize, qCeil(texture.height() * M_SQRT2)) << rotation;
+
+        // 平铺两个周期，跨越纹理的边界
+        QImage tiled(tile.size() * 2, QImage::Format_ARGB32_Premultiplied);
+        tiled.fill(Qt::transparent);
+        QPainter painter(&tiled);
+        painter.fillRect(tiled.rect(), brush);
+        painter.end();
+
+        qint64 uncovered = 0;
+        for (int y = 0; y < tiled.height(); ++y) {
+            const QRgb *line = reinterpret_cast<const QRgb *>(tiled.constScanLine(y));
+            for (int x = 0; x < tiled.width(); ++x)
+                uncovered += qAlpha(line[x]) < 128 ? 1 : 0;
+        }
+
+        ASSERT_LT(uncovered * 100, qint64(tiled.width()) * tiled.height() * 3) << rotation;
+    }
+}
+
+TEST_F(ut_DWaterMarkWidget, sharedTextureBrush)
+{
+    WaterMarkData data = target->data();
+    data.setType(WaterMarkData::Text);
+    data.setLayout(WaterMarkData::Tiled);
+    data.setText("shared texture");
+    data.setRotation(30);
+    target->setData(data);
+
+    // 配置相同的水印界面共享同一份纹理
+    DWaterMarkWidget other(root);
+    other.setData(data);
+    const qint64 cacheKey = target->d_func()->tiledBrush(1.0).textureImage().cacheKey();
+    ASSERT_EQ(other.d_func()->tiledBrush(1.0).textureImage().cacheKey(), cacheKey);
+
+    // 透明度在绘制时处理，不需要重新生成纹理
+    data.setOpacity(0.5);
+    other.setData(data);
+    ASSERT_EQ(other.d_func()->tiledBrush(1.0).textureImage().cacheKey(), cacheKey);
+
+    data.setText("another texture");
+    other.setData(data);
+    ASSERT_NE(other.d_func()->tiledBrush(1.0).textureImage().cacheKey(), cacheKey);
+    ASSERT_EQ(target->d_func()->tiledBrush(1.0).textureImage().cacheKey(), cacheKey);
+
+    // 缩放比不同时使用各自的纹理
+    ASSERT_NE(target->d_func()->tiledBrush(2.0).textureImage().cacheKey(), cacheKey);
+}
@@ -5,6 +5,7 @@
 #include <gtest/gtest.h>
 #include <QTest>
 #include <QDebug>
+#include <QTimer>
 
 #include "dwaterprogress.h"
 
@@ -28,7 +29,8 @@ void ut_DWaterProgress::SetUp()
 
 void ut_DWaterProgress::TearDown()
 {
-    widget->deleteLater();
+    // 立即释放，避免已显示的窗口和动画定时器残留到后续用例
+    delete widget;
 }
 
 TEST_F(ut_DWaterProgress, testDwaterProress)
@@ -51,16 +53,37 @@ TEST_F(ut_DWaterProgress, testDwaterProressSetValue)
     ASSERT_TRUE(progress->value() == 50);
 }
 
-// TODO break
 TEST_F(ut_DWaterProgress, testDwaterProressPaintEvent)
 {
     widget->show();
-    ASSERT_TRUE(QTest::qWaitForWindowExposed(widget, 100));
+    ASSERT_TRUE(QTest::qWaitForWindowExposed(widget));
 }
-// break
 TEST_F(ut_DWaterProgress, testDwaterProressChangeEvent)
 {
     widget->show();
     progress->setPalette(QPalette(QColor(255,255,255)));
-    ASSERT_TRUE(QTest::qWaitForWindowExposed(widget, 100));
+    ASSERT_TRUE(QTest::qWaitForWindowExposed(widget));
+}
+
+TEST_F(ut_DWaterProgress, testDwaterProressTimerVisibility)
+{
+    QTimer *timer = progress->findChild<QTimer *>();
+    ASSERT_TRUE(timer);
+
+    // 控件不可见时不启动动画
+    progress->start();
+    ASSERT_FALSE(timer->isActive());
+
+    widget->show();
+    ASSERT_TRUE(QTest::qWaitForWindowExposed(widget));
+    ASSERT_TRUE(timer->isActive());
+
+    widget->hide();
+    ASSERT_FALSE(timer->isActive());
+
+    widget->show();
+    ASSERT_TRUE(timer->isActive());
+
+    progress->stop();
+    ASSERT_FALSE(timer->isActive());
 }